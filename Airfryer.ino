@@ -46,6 +46,11 @@
 #include "MultiButton.h"
 #include <Encoder.h>
 #include "Eeprom_cookbook.h"
+#include "Eeprom_checkpoint.h"
+#include "Eeprom_history.h"
+#include "Clock.h"
+#include "Benchmark.h"
+#include <avr/wdt.h>
 
 /* PROPERTIES */
 const byte heaterPin      = 8;     //D8 = pin 14
@@ -61,6 +66,9 @@ const int buzzFrequency   = 3520;  //buzzer frequency (3520 = NOTE_A7)
 const int exitEditDelay   = 10;    //in seconds! 
 const int powerOffTimeout = 60;    //in seconds! PowerOff does not work in WokWi simulation
 const int preHeatTimeout  = 300;   //in seconds!
+const int checkpointInterval = 120; //in seconds! Saves the running cook at least every [checkpointInterval] seconds. (and at every step)
+const int heaterWatts     = 2100;  //heating coil power (HD9240), used for the energy usage in the history.
+const int fanWatts        = 30;    //fan motor power (approx.), used for the energy usage in the history.
 const int tempSteps[]     = {1,  5, 10,  20,  30,  40,  50,  60}; //rotary intervals. (slow > fast rotations)
 const int timeSteps[]     = {1, 15, 60, 120, 180, 240, 300, 360}; //rotary intervals. (slow > fast rotations)
 
@@ -70,7 +78,10 @@ LiquidCrystal_I2C lcd(0x27, 16, 2); //find I2C address with I2C_scanner script
 /* FOODLIST */
 //max steps per product. See MAX_STEPS in Product.h
 Product           product = { "Custom 0", 0, MAX_STEPS };
-EEPROM_Cookbook   cookbook(1024);
+//EEPROM: cookbook | history | checkpoint
+EEPROM_Cookbook   cookbook(1024 - EEPROM_Checkpoint::size - EEPROM_History::size);
+EEPROM_History    history(1024 - EEPROM_Checkpoint::size - EEPROM_History::size);
+EEPROM_Checkpoint checkpoint(1024 - EEPROM_Checkpoint::size); //last bytes of the EEPROM
 
 /* GLOBAL VARS */
 LCD1602           screen(lcd);
@@ -82,12 +93,17 @@ byte              menuStepIdx       = 0;
 byte              ADCSRA_State;     //used for hibernate state.
 long              oldPosition       = -999; //rotary last position
 byte              switchPreHeatText = 0; //counter for switching preheat text on screen
-unsigned long     editingSince      = 0;
-unsigned long     lastActionOn      = millis();
-bool              isDirty           = false;
+unsigned long     editingSince      = 0; //in seconds (sysClock)
+unsigned long     lastActionOn      = 0; //in seconds (sysClock)
+unsigned int      dirtyFields       = 0; //edited product fields (FIELD_* flags) that are not saved yet.
 short             dialogResult      = 0;
+unsigned long     checkpointedOn    = 0; //elapsed seconds of the running cook when it was saved.
 
 void setup() {  
+
+  //WATCHDOG (keep disabled while booting)
+  MCUSR = 0;
+  wdt_disable();
     
   //SERIAL 
   delay(100);
@@ -115,19 +131,54 @@ void setup() {
     lcd.print(F("Preparing EEPROM"));
     lcd.setCursor(0,1);
     lcd.print(F("structure..."));
-    cookbook.prepareEEPROM();
+    //edited products that no longer fit are printed on Serial. (see README)
+    byte lostProducts = cookbook.prepareEEPROM();
+    if(lostProducts > 0) {
+      lcd.clear();
+      lcd.print(lostProducts);
+      lcd.print(F(" product(s)"));
+      lcd.setCursor(0,1);
+      lcd.print(F("lost! Click..."));
+      while(digitalRead(buttonPin)) { delay(10); }  //wait for a click
+      while(!digitalRead(buttonPin)) { delay(10); }
+    }
   }
   cookbook.readProduct(menuProductIdx, &product);
-  screen.printMenu(product.name); //show menu on startup
+
+#if BENCHMARK_MODE
+  runBenchmarks();
+#endif
+  
+  //interrupted cook? (power loss or watchdog reset)
+  CookCheckpoint cp;
+  if(checkpoint.read(&cp)) {
+    menuProductIdx = cp.productIdx;
+    cookbook.readProduct(menuProductIdx, &product);
+    screen.current = SCREEN_RESUME;
+    screen.printResumeDialog(dialogResult = DIALOG_RESULT_YES);
+  } else {
+    screen.printMenu(product.name); //show menu on startup
+  }
+
+  //WATCHDOG (resets the device when the loop hangs)
+  wdt_enable(WDTO_2S);
 }
 
 void loop() {
 
+  wdt_reset();
+  //sample the time once for this pass.
+  sysClock.tick();
+
+  //halt on a latched engine fault. (heater and fan are off, reset to continue)
+  if(engine.getFault() != FAULT_NONE)
+    return;
+
   //go to sleep?
   checkSleepMode();  
   
   //exit edit mode when idle for [exitEditDelay] seconds.
-  bool exitEdit = (millis() - editingSince) / 1000 >= exitEditDelay;
+  bool exitEdit = sysClock.secondsSince(editingSince) >= exitEditDelay;
   if(screen.current > SCREEN_RUNNING && exitEdit) {
     if(screen.current == SCREEN_EDIT_NAME){
       screen.current = SCREEN_MENU;
@@ -146,13 +197,23 @@ void loop() {
     screen.menuBlinkItem = !screen.menuBlinkItem;
     if(screen.current != SCREEN_MENU 
     && screen.current != SCREEN_MENU_SAVE
-    && screen.current != SCREEN_EDIT_NAME)
+    && screen.current != SCREEN_RESUME
+    && screen.current != SCREEN_EDIT_NAME
+    && screen.current != SCREEN_ERROR)
       printRunDisplay();
   }
   
   //reset hibernate timeout when engine is running
   if(engine.isRunning())
-    lastActionOn = millis();
+    lastActionOn = sysClock.getSeconds();
+
+  //save the running cook every [checkpointInterval] seconds.
+  if(engine.isRunning() && engine.getElapsedSeconds() - checkpointedOn >= checkpointInterval)
+    saveCheckpoint();
+  
+  //print the cook history when requested over Serial. (send 'h')
+  if(Serial.available() && Serial.read() == 'h')
+    printHistory();
   
   //execute user interactions
   userInteraction();
@@ -160,19 +221,22 @@ void loop() {
 
 void checkSleepMode() {
   //Did device State changed
-  bool powerOff = (millis() - lastActionOn) / 1000 >= powerOffTimeout;
+  bool powerOff = sysClock.secondsSince(lastActionOn) >= powerOffTimeout;
   if(powerOff) {
       //Serial.println("Hibernate");      
       screen.lcdPowerMode(false);
+      wdt_disable(); //the watchdog would reset the device while sleeping.
       goToSleep(); 
       //wakes-up here...        
-      lastActionOn = millis();  // set last action time. 
+      sysClock.tick();
+      lastActionOn = sysClock.getSeconds();  // set last action time. 
       engine.resetTemperature(); //reset temp buffer.
       screen.lcdPowerMode(true);         
       rotary.write(0); //reset rotary movements
       //Serial.println("Woke up from hibernate");        
       //wait for button release (= LOW while pressed)
       while(!digitalRead(buttonPin)) { delay(10); };            
+      wdt_enable(WDTO_2S);
   }
 }
 
@@ -231,7 +295,7 @@ void userInteraction() {
       
       //Rotary actions in menu-
       if(rotaryPosition != 0) {
-        if(isDirty) {
+        if(dirtyFields) {
           screen.current = SCREEN_MENU_SAVE;
           screen.printSaveDialog(dialogResult = 0);          
         } else {
@@ -248,8 +312,10 @@ void userInteraction() {
         case BTN_DOUBLE_CLICK: /* SELECT & RUN */ {
           bool startEngine = buttonState == BTN_DOUBLE_CLICK;
           screen.current = startEngine ? SCREEN_RUNNING : SCREEN_PRODUCT;
-          if(startEngine)
+          if(startEngine) {
             engine.start(&product);             
+            saveCheckpoint();
+          }
           menuStepIdx = 0; //reset to first step
           lcd.clear();
           printRunDisplay();
@@ -280,16 +346,41 @@ void userInteraction() {
       
       if(buttonState == BTN_SINGLE_CLICK) {
         switch(dialogResult) {
-          case DIALOG_RESULT_NO:  cookbook.readProduct(menuProductIdx, &product); break;
-          case DIALOG_RESULT_YES: cookbook.writeProduct(menuProductIdx, product); break;
+          case DIALOG_RESULT_NO:  cookbook.readFields(menuProductIdx, &product, dirtyFields); break;
+          case DIALOG_RESULT_YES: cookbook.writeFields(menuProductIdx, &product, dirtyFields); break;
         }
-        isDirty = dialogResult == DIALOG_RESULT_ABORT;
+        if(dialogResult != DIALOG_RESULT_ABORT)
+          dirtyFields = 0;
         screen.current = SCREEN_MENU; //todo: should go into LCD1602 class. PrintMenu() = Screen Menu...
         screen.printMenu(product.name);
       }
 
       break;
     }
+    case SCREEN_RESUME:
+    /* =================================================================
+     * Rotate rotary = change dialog option
+     * Pressed once  = resume the interrupted cook or discard it
+     * ================================================================= */
+
+      if(rotaryPosition != 0) {
+        short prevDialogResult = dialogResult;
+        dialogResult = constrain(dialogResult-direction, DIALOG_RESULT_NO, DIALOG_RESULT_YES);
+        if(prevDialogResult != dialogResult)
+          screen.printResumeDialog(dialogResult);
+      }
+
+      if(buttonState == BTN_SINGLE_CLICK) {
+        if(dialogResult == DIALOG_RESULT_YES) {
+          resumeCook();
+        } else {
+          checkpoint.clear();
+          screen.current = SCREEN_MENU;
+          screen.printMenu(product.name);
+        }
+      }
+      break;
+
     case SCREEN_PRODUCT:
     /* =================================================================
      * Rotate rotary = Enter edit mode and change time
@@ -307,6 +398,7 @@ void userInteraction() {
           screen.current = SCREEN_RUNNING;
           menuStepIdx = 0;          
           engine.start(&product);                   
+          saveCheckpoint();
           break;
         
         case BTN_DOUBLE_CLICK: /* ENTER MENU */
@@ -361,7 +453,7 @@ void userInteraction() {
       if(rotaryPosition != 0) {
         char currChar = rollNameChar(screen.textEditIdx, rotaryPosition);
         screen.changeChar(currChar, screen.textEditIdx + 2 ,1);
-        isDirty = true;
+        dirtyFields |= FIELD_NAME;
       }
 
       switch (buttonState) {
@@ -403,11 +495,12 @@ void userInteraction() {
             currStep->timeInSec = newTime < 0 ? 0 : newTime;
             break;
           }
-          case SCREEN_EDIT_TEMP: currStep->temp = currStep->temp + (direction * tempSteps[abs(rotaryPosition)-1]); break;
+          case SCREEN_EDIT_TEMP: currStep->temp = constrain(currStep->temp + (direction * tempSteps[abs(rotaryPosition)-1]), 0, STEP_TEMP_MAX); break;
           case SCREEN_EDIT_PREHEAT: product.preHeat = !product.preHeat; break;
         }
         
-        isDirty |= !engine.isRunning() && screen.current > SCREEN_EDIT_STEP;        
+        if(!engine.isRunning() && screen.current > SCREEN_EDIT_STEP)
+          dirtyFields |= screen.current == SCREEN_EDIT_PREHEAT ? FIELD_PREHEAT : FIELD_STEP(menuStepIdx);
         screen.menuBlinkItem = false; //delay blink when editing (true = hidden)    
         printRunDisplay();
       } 
@@ -436,10 +529,10 @@ void userInteraction() {
   //reset timers
   if(buttonState > 0 || rotaryPosition != 0){
     // Reset powerOff timer
-    lastActionOn = millis();      
+    lastActionOn = sysClock.getSeconds();      
     // Reset edit timer.
     if(screen.current > SCREEN_RUNNING) {
-      editingSince = millis();
+      editingSince = sysClock.getSeconds();
       screen.menuBlinkItem = false;
     }
   }
@@ -457,9 +550,10 @@ void printRunDisplay() {
   //First line
   if(engine.isRunning()) {
     byte tempSign = engine.isOnTemperature() ? '<' : '>';
-    if(engine.getPreHeat()) {  
-      char* actionText = engine.getPreHeatReached() ? "START NOW?" : "!PREHEAT!";
-      screen.printProductLine(++switchPreHeatText % 10 > 4 ? product.name : actionText, engine.getTemperature(), tempSign);
+    if(engine.getPreHeat() && !engine.getPreHeatReached()) {
+      screen.printPreHeatLine(engine.getPreHeatEtaSeconds(), engine.getTemperature(), tempSign);
+    } else if(engine.getPreHeat()) {
+      screen.printProductLine(++switchPreHeatText % 10 > 4 ? product.name : "START NOW?", engine.getTemperature(), tempSign);
     } else {
       screen.printRunLine(engine.getElapsedSeconds(), engine.getTemperature(), tempSign);
     }
@@ -475,14 +569,135 @@ void printRunDisplay() {
      currStep->beep); 
 }
 
+//stores the running cook in EEPROM. (only changed bytes are written)
+void saveCheckpoint() {
+  CookCheckpoint cp = {};
+  cp.productIdx = menuProductIdx;
+  cp.currentStep = engine.getCurrentStepIdx();
+  cp.preHeat = engine.getPreHeat();
+  cp.stepsCount = engine.getStepsCount();
+  cp.elapsedSeconds = checkpointedOn = engine.getElapsedSeconds();
+  for(byte x = 0; x < cp.stepsCount; x++)
+    memcpy(&cp.steps[x], engine.getStep(x), sizeof(CookStep));
+  checkpoint.write(&cp);
+}
+
+//restarts the engine with the steps and elapsed time of the interrupted cook.
+void resumeCook() {
+  CookCheckpoint cp;
+  if(checkpoint.read(&cp)) {
+    Product resumed = product; //keep the name of the cookbook product.
+    resumed.preHeat = cp.preHeat;
+    resumed.stepsCount = cp.stepsCount;
+    memcpy(resumed.steps, cp.steps, sizeof(cp.steps));
+    engine.start(&resumed, cp.currentStep, cp.elapsedSeconds);
+    checkpointedOn = cp.elapsedSeconds;
+  }
+  screen.current = engine.isRunning() ? SCREEN_RUNNING : SCREEN_PRODUCT;
+  menuStepIdx = engine.getCurrentStepIdx();
+  lcd.clear();
+  printRunDisplay();
+}
+
+/*
+  prints the stored cooks, newest first, as CSV. Per step: programmed and actual seconds.
+  session,product,steps_done,fault,preheat_s,heater_s,fan_s,energy_wh,s1_prog,s1_act,...
+*/
+void printHistory() {
+  SessionRecord record;
+  Serial.print(F("session,product,steps_done,fault,preheat_s,heater_s,fan_s,energy_wh"));
+  for(byte x = 1; x <= MAX_STEPS; x++) {
+    Serial.print(F(",s")); Serial.print(x); Serial.print(F("_prog"));
+    Serial.print(F(",s")); Serial.print(x); Serial.print(F("_act"));
+  }
+  Serial.println();
+  for(byte age = 0; history.read(age, &record); age++) {
+    CookSession* s = &record.session;
+    Serial.print(record.number);        Serial.print(',');
+    Serial.print(record.productIdx+1);  Serial.print(',');
+    Serial.print(s->stepsDone);         Serial.print(',');
+    Serial.print(s->fault);             Serial.print(',');
+    Serial.print(s->preHeatSeconds);    Serial.print(',');
+    Serial.print(s->heaterOnSeconds);   Serial.print(',');
+    Serial.print(s->fanOnSeconds);      Serial.print(',');
+    Serial.print(((unsigned long)s->heaterOnSeconds * heaterWatts + (unsigned long)s->fanOnSeconds * fanWatts) / 3600);
+    for(byte x = 0; x < MAX_STEPS; x++) {
+      Serial.print(','); Serial.print(s->programmedSeconds[x]);
+      Serial.print(','); Serial.print(s->stepSeconds[x]);
+    }
+    Serial.println();
+  }
+}
+
+#if BENCHMARK_MODE
+void benchmarkCallBack(int stepIdx) { /* no screen, buzzer or EEPROM actions while benchmarking */ }
+
+//measures the code that runs every tick or every loop pass. (see Benchmark.h)
+void runBenchmarks() {
+  Benchmark bench;
+  Product benchProduct = { "Benchmark", 0, MAX_STEPS }; //zero temperature: heater and fan stay off.
+  static FryEngine benchEngine(heaterPin, fanPin, tempSensorPin, preHeatTimeout, &benchmarkCallBack);
+  for(byte x = 0; x < MAX_STEPS; x++)
+    benchProduct.steps[x].timeInSec = 600;
+
+  sysClock.tick();
+  benchEngine.start(&benchProduct);
+  bench.begin();
+  
+  //10x updateTemperature + getTemperature
+  BENCHMARK(bench, "FryEngine::resetTemperature", 100, benchEngine.resetTemperature());
+  BENCHMARK(bench, "FryEngine::getTemperature", 1000, benchEngine.getTemperature());
+  BENCHMARK(bench, "FryEngine::getRemainingSeconds", 1000, benchEngine.getRemainingSeconds());
+  
+  //engine tick (every 500ms)
+  for(byte x = 0; x < 10; x++) {
+    delay(500);
+    sysClock.tick();
+    bench.start();
+    benchEngine.timer();
+    bench.pause();
+  }
+  bench.report(F("FryEngine::timer(tick)"), 10);
+  
+  //loop pass without engine tick
+  sysClock.tick();
+  BENCHMARK(bench, "FryEngine::timer(idle)", 1000, benchEngine.timer());
+  BENCHMARK(bench, "MultiButton::check", 1000, button.check());
+  BENCHMARK(bench, "readRotaryPosition", 1000, readRotaryPosition());
+  BENCHMARK(bench, "LCD1602::printStepLine", 10, screen.printStepLine(0, 600, 180, true));
+  BENCHMARK(bench, "LCD1602::printRunLine", 10, screen.printRunLine(125, 180, '>'));
+  BENCHMARK(bench, "EEPROM_Cookbook::readProduct", 100, cookbook.readProduct(0, &benchProduct));
+  
+  bench.end();
+  benchEngine.stop();
+  lcd.clear();
+}
+#endif
+
 void stepCompletedCallBack(int stepIdx) {
 
+  //Actions when engine detects a fault.
+  if(stepIdx == ENGINE_FAULT_STEP) {
+    checkpoint.clear();
+    screen.current = SCREEN_ERROR;
+    lcd.noBlink();
+    screen.printError(engine.getFault());
+    tone(speakerPin, buzzFrequency, 2000);
+    return;
+  }
+
   //Actions when engine stops.
   if(stepIdx == ENGINE_STOPPED_STEP) {
+    checkpoint.clear();
+    history.write(menuProductIdx, engine.getSession());
     screen.current = SCREEN_PRODUCT;
     menuStepIdx = 0;
   } 
   
+  //save the cook at each step boundary.
+  if(stepIdx >= 0 && engine.getCurrentStepIdx() < engine.getStepsCount())
+    saveCheckpoint();
+  
   //show next step on screen
   if (stepIdx == menuStepIdx){
     menuStepIdx = engine.getCurrentStepIdx();
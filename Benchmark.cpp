@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+
+#include "Arduino.h"
+#include "Benchmark.h"
+
+#if BENCHMARK_MODE
+
+static volatile unsigned int timer1Overflows = 0;
+
+ISR(TIMER1_OVF_vect) {
+  timer1Overflows++;
+}
+
+void Benchmark::begin() {
+  //Timer1 counts every CPU cycle.
+  noInterrupts();
+  _tccr1a = TCCR1A;
+  _tccr1b = TCCR1B;
+  _timsk1 = TIMSK1;
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+  TCNT1 = 0;
+  TIMSK1 = _BV(TOIE1);
+  interrupts();
+  //measure the overhead of the measurement itself.
+  _overhead = 0;
+  _cycles = 0;
+  start();
+  pause();
+  _overhead = _cycles;
+  _cycles = 0;
+  Serial.println(F("name,iterations,cycles_per_call,us_per_call"));
+}
+
+//restores the Timer1 settings. (eg. the Arduino core prepares Timer1 for PWM)
+void Benchmark::end() {
+  noInterrupts();
+  TIMSK1 = _timsk1;
+  TCCR1A = _tccr1a;
+  TCCR1B = _tccr1b;
+  TCNT1 = 0;
+  interrupts();
+}
+
+void Benchmark::start() {
+  _startedOn = cycles();
+}
+
+//adds the cycles since start. (call start again to continue)
+void Benchmark::pause() {
+  _cycles += cycles() - _startedOn - _overhead;
+}
+
+void Benchmark::report(const __FlashStringHelper* name, unsigned int iterations) {
+  unsigned long perCall = _cycles / iterations;
+  Serial.print(name);
+  Serial.print(',');
+  Serial.print(iterations);
+  Serial.print(',');
+  Serial.print(perCall);
+  Serial.print(',');
+  Serial.println(perCall / (F_CPU / 1000000.0), 2);
+  _cycles = 0;
+}
+
+unsigned long Benchmark::cycles() {
+  noInterrupts();
+  unsigned int count = TCNT1;
+  unsigned long overflows = timer1Overflows;
+  //overflow that is not handled by the ISR yet.
+  if((TIFR1 & _BV(TOV1)) && count < 0x8000)
+    overflows++;
+  interrupts();
+  return (overflows << 16) | count;
+}
+
+#endif
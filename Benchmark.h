@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+ 
+#ifndef Benchmark_h
+  #define Benchmark_h
+  #include "Arduino.h"
+
+  //measure the hot paths at startup and print the results to Serial. (1 = on, 0 = off)
+  #define BENCHMARK_MODE 0
+
+  //measures [code] [iterations] times and prints the cycles per call.
+  #define BENCHMARK(bench, name, iterations, code) \
+    do { \
+      bench.start(); \
+      for(int benchIdx = 0; benchIdx < (iterations); benchIdx++) { code; } \
+      bench.pause(); \
+      bench.report(F(name), iterations); \
+    } while(0)
+
+  /*
+   * Counts CPU cycles with Timer1. (no prescaler, overflows are counted in the ISR)
+   * Interrupts stay enabled, so Timer0 (millis) and the rotary interrupts are included in the counts.
+   * The Timer1 settings are restored by end().
+   * CSV output, one line per benchmark:
+   * name,iterations,cycles_per_call,us_per_call
+   */
+  class Benchmark {
+    
+    public:
+      void begin();
+      void end();
+      void start();
+      void pause();
+      void report(const __FlashStringHelper* name, unsigned int iterations);
+      
+    private:
+      unsigned long cycles();
+      unsigned long _startedOn;
+      unsigned long _cycles;
+      unsigned long _overhead; //cycles of a start/pause without code.
+      byte _tccr1a, _tccr1b, _timsk1; //Timer1 settings before begin.
+  };
+#endif
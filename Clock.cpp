@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+
+#include "Arduino.h"
+#include "Clock.h"
+
+Clock sysClock;
+
+//call once at the start of each loop pass.
+void Clock::tick() {
+  _millis = millis();
+  //count the passed seconds. (catches up when a pass took longer than a second)
+  while(_millis - _secondStartedOn >= 1000) {
+    _secondStartedOn += 1000;
+    _seconds++;
+  }
+}
+
+unsigned long Clock::getMillis() {
+  return _millis;
+}
+
+unsigned long Clock::getSeconds() {
+  return _seconds;
+}
+
+//millis passed in the current second. (0-999)
+unsigned int Clock::getSecondMillis() {
+  return _millis - _secondStartedOn;
+}
+
+unsigned long Clock::millisSince(unsigned long since) {
+  return _millis - since;
+}
+
+unsigned long Clock::secondsSince(unsigned long since) {
+  return _seconds - since;
+}
+
+//seconds since [since] + [sinceMillis], a second only counts when it is complete.
+unsigned long Clock::secondsSince(unsigned long since, unsigned int sinceMillis) {
+  unsigned long seconds = _seconds - since;
+  if(seconds > 0 && getSecondMillis() < sinceMillis)
+    seconds--;
+  return seconds;
+}
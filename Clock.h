@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+ 
+#ifndef Clock_h
+  #define Clock_h
+  #include "Arduino.h"
+
+  /*
+   * Single time source for the engine, input and screen timers.
+   * millis() is sampled once per loop pass (tick) so all timers see the same time.
+   * Seconds are counted incrementally (no divisions) and only wrap after 136 years. 
+   * Use millisSince / secondsSince to compare: unsigned subtraction is overflow safe.
+   * Pass the getSecondMillis() of the start to secondsSince to count whole seconds from the exact start.
+   */
+  class Clock {
+    
+    public:
+      void          tick();
+      unsigned long getMillis();
+      unsigned long getSeconds();
+      unsigned int  getSecondMillis();
+      unsigned long millisSince(unsigned long since);
+      unsigned long secondsSince(unsigned long since);
+      unsigned long secondsSince(unsigned long since, unsigned int sinceMillis);
+      
+    private:
+      unsigned long _millis;
+      unsigned long _seconds;
+      unsigned long _secondStartedOn; //millis when the current second started.
+  };
+
+  extern Clock sysClock;
+#endif
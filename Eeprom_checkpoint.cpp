@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+
+#include "Arduino.h"
+#include "Eeprom_checkpoint.h" 
+#include "Eeprom_checksum.h" 
+
+EEPROM_Checkpoint::EEPROM_Checkpoint(int address) {
+  _address = address;
+}
+
+//returns true when an interrupted cook is stored.
+bool EEPROM_Checkpoint::read(CookCheckpoint* cp) {
+  int8_t slot = getNewestSlot();
+  return slot >= 0 && readSlot(slot, cp);
+}
+
+//writes to the slot after the newest one. Only changed bytes are written. (EEPROM.put updates)
+void EEPROM_Checkpoint::write(CookCheckpoint* cp) {
+  int8_t newest = getNewestSlot();
+  byte sequence = newest < 0 ? 0 : EEPROM.read(_address + newest * slotSize + 2) + 1;
+  int address = _address + ((newest + 1) % CHECKPOINT_SLOTS) * slotSize;
+  EEPROM.put(address + 3, *cp);
+  EEPROM.update(address + 2, sequence);
+  EEPROM.update(address + 1, checksum(sequence, cp));
+  EEPROM.update(address, CHECKPOINT_MAGIC);
+}
+
+void EEPROM_Checkpoint::clear() {
+  for(byte x = 0; x < CHECKPOINT_SLOTS; x++)
+    EEPROM.update(_address + x * slotSize, 0);
+}
+
+//slot with the highest sequence (byte wraps around), -1 when no slot is valid.
+int8_t EEPROM_Checkpoint::getNewestSlot() {
+  CookCheckpoint cp;
+  int8_t newest = -1;
+  byte newestSequence = 0;
+  for(byte x = 0; x < CHECKPOINT_SLOTS; x++) {
+    if(!readSlot(x, &cp))
+      continue;
+    byte sequence = EEPROM.read(_address + x * slotSize + 2);
+    if(newest < 0 || (byte)(sequence - newestSequence) < 128) {
+      newest = x;
+      newestSequence = sequence;
+    }
+  }
+  return newest;
+}
+
+bool EEPROM_Checkpoint::readSlot(byte slot, CookCheckpoint* cp) {
+  int address = _address + slot * slotSize;
+  if(EEPROM.read(address) != CHECKPOINT_MAGIC)
+    return false;
+  EEPROM.get(address + 3, *cp);
+  return EEPROM.read(address + 1) == checksum(EEPROM.read(address + 2), cp) 
+      && cp->stepsCount <= MAX_STEPS 
+      && cp->currentStep < cp->stepsCount;
+}
+
+byte EEPROM_Checkpoint::checksum(byte sequence, CookCheckpoint* cp) {
+  return eepromChecksum(CHECKPOINT_MAGIC ^ sequence, cp, sizeof(CookCheckpoint));
+}
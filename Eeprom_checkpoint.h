@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+ 
+#ifndef eeprom_checkpoint_h
+  #define eeprom_checkpoint_h
+  #include "Arduino.h"
+  #include <EEPROM.h>
+  #include "Product.h"
+
+  /*
+   * EEPROM STRUCTURE (starting at the given address):
+   * - slots[]      31 bytes * CHECKPOINT_SLOTS (written in turn, spreads the EEPROM wear)
+   * SLOT STRUCTURE:
+   * - Magic        1 byte  (CHECKPOINT_MAGIC when a cook is running)
+   * - Checksum     1 byte  (detects a checkpoint that was only partially written)
+   * - Sequence     1 byte  (the slot with the highest sequence is the newest)
+   * - Checkpoint   28 bytes
+   * CHECKPOINT STRUCTURE:
+   * - ProductIdx   1 byte
+   * - CurrentStep  1 byte
+   * - PreHeat      1 byte
+   * - StepsCount   1 byte
+   * - Elapsed      4 bytes (seconds)
+   * - steps[]      4 bytes * MAX_STEPS  (5 steps = 20 bytes)
+   * TOTAL with 5 steps and 3 slots: 93 bytes.
+   * 
+   */
+
+  #define CHECKPOINT_MAGIC 0xA5
+  #define CHECKPOINT_SLOTS 3
+
+  struct CookCheckpoint {
+    byte productIdx;
+    byte currentStep;
+    bool preHeat;
+    byte stepsCount;
+    unsigned long elapsedSeconds;
+    CookStep steps[MAX_STEPS];
+  };
+  
+  class EEPROM_Checkpoint {
+    
+    public:
+      EEPROM_Checkpoint(int address);
+      bool read(CookCheckpoint* cp);
+      void write(CookCheckpoint* cp);
+      void clear();
+      //(magic + checksum + sequence + checkpoint) * slots
+      static const int slotSize = 3 + sizeof(CookCheckpoint);
+      static const int size = slotSize * CHECKPOINT_SLOTS;
+      
+    private:
+      int _address;
+      int8_t getNewestSlot();
+      bool readSlot(byte slot, CookCheckpoint* cp);
+      byte checksum(byte sequence, CookCheckpoint* cp);
+  };
+
+#endif
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+
+#include "Arduino.h"
+#include "Eeprom_checksum.h" 
+
+byte eepromChecksum(byte seed, const void* data, unsigned int length) {
+  byte sum = seed;
+  const byte* bytes = (const byte*)data;
+  for(unsigned int x = 0; x < length; x++)
+    sum = (sum << 1 | sum >> 7) ^ bytes[x]; //rotate and xor
+  return sum;
+}
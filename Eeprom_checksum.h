@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+ 
+#ifndef eeprom_checksum_h
+  #define eeprom_checksum_h
+  #include "Arduino.h"
+
+  //rotate and xor checksum of [length] bytes, starting from [seed].
+  //Detects a record that was only partially written. (power loss)
+  byte eepromChecksum(byte seed, const void* data, unsigned int length);
+
+#endif
@@ -9,7 +9,7 @@
 #include "Arduino.h"
 #include "Eeprom_cookbook.h" 
 
-static const byte EEPROM_Cookbook::eeprom_check[] = { 'A','A','I','R', 1, MAX_STEPS }; 
+static const byte EEPROM_Cookbook::eeprom_check[] = { 'A','A','I','R', 2, MAX_STEPS }; 
 
 EEPROM_Cookbook::EEPROM_Cookbook(int max_eeprom_bytes) {	
   _max_eeprom_bytes = max_eeprom_bytes;  
@@ -19,51 +19,76 @@ int EEPROM_Cookbook::getProductAddress(byte productIdx) {
   return sizeof(eeprom_check) + (productIdx * productSize);
 }
 
+int EEPROM_Cookbook::getStepAddress(byte productIdx, byte stepIdx) {
+  return getProductAddress(productIdx) + stepsOffset + (stepIdx * sizeof(CookStep));
+}
+
 void EEPROM_Cookbook::readProduct(byte productIdx, Product* p) {
-  
-  int pos =  getProductAddress(productIdx);
+  readFields(productIdx, p, FIELD_ALL);
+}
 
-  //read name
-  char name[PRODUCTNAME_MAX_LEN] = {};    
-  for(byte x = 0; x < PRODUCTNAME_MAX_LEN; x++) 
-    name[x] =EEPROM.read(pos + x);
-  
-  memcpy(p->name, name, strlen(name)+1);  
-  //p->setName(name);
-  pos += PRODUCTNAME_MAX_LEN - 1; // 14;
-  
-  p->preHeat = EEPROM.read(pos++);
-  p->stepsCount = EEPROM.read(pos++);
-  
-  for(int x = 0; x < p->stepsCount; x++) {
-    CookStep tempStep = {};      
-    EEPROM.get(pos, tempStep);
-    memcpy(&p->steps[x], &tempStep, sizeof(tempStep));
+void EEPROM_Cookbook::writeProduct(byte productIdx, Product* p) {
+  writeFields(productIdx, p, FIELD_ALL);
+}
 
-    pos += sizeof(CookStep); // 4;
+//reads only the given fields (FIELD_* flags) straight into the product.
+void EEPROM_Cookbook::readFields(byte productIdx, Product* p, unsigned int fields) {
+  if(fields & FIELD_NAME)
+    readName(productIdx, p->name);
+  if(fields & FIELD_PREHEAT)
+    p->preHeat = readPreHeat(productIdx);
+  if(fields == FIELD_ALL)
+    p->stepsCount = min(EEPROM.read(getProductAddress(productIdx) + stepsCountOffset), MAX_STEPS); //unused EEPROM: 0xFF
+  for(byte x = 0; x < p->stepsCount; x++) {
+    if(fields & FIELD_STEP(x))
+      readStep(productIdx, x, &p->steps[x]);
   }
 }
 
-void EEPROM_Cookbook::writeProduct(byte productIdx, Product p) {
-  
-  //get address for first product
-  int pos = getProductAddress(productIdx);
-  
-  //write name
-  writeCharArray(pos,p.name,strlen(p.name)+1); // string + null char    
-  pos += PRODUCTNAME_MAX_LEN - 1; // 14;
-  
-  //byte stepCount = 8; // = MAX_STEPS!
-  EEPROM.update(pos++, p.preHeat);
-  EEPROM.update(pos++, p.stepsCount);
-  
-  //write steps
-  for(uint8_t x = 0; x < p.stepsCount; x++) {
-    EEPROM.put(pos, p.steps[x]);
-    pos += sizeof(CookStep); // 4;
+//writes only the given fields (FIELD_* flags) of the product.
+void EEPROM_Cookbook::writeFields(byte productIdx, Product* p, unsigned int fields) {
+  if(fields & FIELD_NAME)
+    writeName(productIdx, p->name);
+  if(fields & FIELD_PREHEAT)
+    writePreHeat(productIdx, p->preHeat);
+  if(fields == FIELD_ALL)
+    EEPROM.update(getProductAddress(productIdx) + stepsCountOffset, p->stepsCount);
+  for(byte x = 0; x < p->stepsCount; x++) {
+    if(fields & FIELD_STEP(x))
+      writeStep(productIdx, x, &p->steps[x]);
   }
 }
 
+//name buffer must hold PRODUCTNAME_MAX_LEN chars.
+void EEPROM_Cookbook::readName(byte productIdx, char* name) {
+  int pos = getProductAddress(productIdx);
+  for(byte x = 0; x < PRODUCTNAME_MAX_LEN - 1; x++) 
+    name[x] = EEPROM.read(pos + x);
+  name[PRODUCTNAME_MAX_LEN - 1] = 0; //a name of 14 chars is stored without null terminator.
+}
+
+void EEPROM_Cookbook::writeName(byte productIdx, char* name) {
+  int len = strlen(name) + 1; // string + null char
+  writeCharArray(getProductAddress(productIdx), name, min(len, PRODUCTNAME_MAX_LEN - 1));
+}
+
+bool EEPROM_Cookbook::readPreHeat(byte productIdx) {
+  return EEPROM.read(getProductAddress(productIdx) + preHeatOffset);
+}
+
+void EEPROM_Cookbook::writePreHeat(byte productIdx, bool preHeat) {
+  EEPROM.update(getProductAddress(productIdx) + preHeatOffset, preHeat);
+}
+
+void EEPROM_Cookbook::readStep(byte productIdx, byte stepIdx, CookStep* step) {
+  EEPROM.get(getStepAddress(productIdx, stepIdx), *step);
+}
+
+//only changed bytes are written. (EEPROM.put updates)
+void EEPROM_Cookbook::writeStep(byte productIdx, byte stepIdx, CookStep* step) {
+  EEPROM.put(getStepAddress(productIdx, stepIdx), *step);
+}
+
 void EEPROM_Cookbook::writeCharArray(int address, char* text, int len) {
   for(uint8_t x = 0; x < len; x++)
     EEPROM.update(address + x, text[x]);
@@ -76,21 +101,32 @@ int EEPROM_Cookbook::count() {
 
 
 bool EEPROM_Cookbook::containsData() {    
+  return containsFormat(eeprom_check[4]);
+}
+
+//checks the EEPROM header for the given format version.
+bool EEPROM_Cookbook::containsFormat(byte version) {
   for(uint8_t x = 0; x < sizeof(eeprom_check); x++) {
-    if(EEPROM[x] != eeprom_check[x])
+    if(EEPROM[x] != (x == 4 ? version : eeprom_check[x]))
       return false;
   }
   return true;
 }
 
-void EEPROM_Cookbook::prepareEEPROM(bool force = false) {
+//Returns the number of edited products that did not fit when upgrading from format 1. (printed on Serial)
+byte EEPROM_Cookbook::prepareEEPROM(bool force = false) {
+  byte lost = 0;
   if(!containsData() || force) {    
-    int maxEntries = count();    
+    //format 1 has the same products, without history and checkpoint: keep them.
+    bool upgrade = !force && containsFormat(1);
+    if(upgrade)
+      lost = moveDroppedProducts();
+    int maxEntries = upgrade ? 0 : count();    
     for(byte x = 0; x < maxEntries; x++) {
       int pos = getProductAddress(x);
 
-      char name[PRODUCTNAME_MAX_LEN] = "Custom ";       
-      itoa(x+1, name+7, 10);
+      char name[PRODUCTNAME_MAX_LEN];
+      getDefaultName(x, name);
 
       writeCharArray(pos,name,strlen(name)+1); // string + null char    
       pos += PRODUCTNAME_MAX_LEN - 1; // 14;
@@ -102,7 +138,63 @@ void EEPROM_Cookbook::prepareEEPROM(bool force = false) {
         EEPROM.update(pos+i, 0);
 
     }    
+    //clear the area after the cookbook. (history and checkpoint)
+    for(int pos = _max_eeprom_bytes; pos < EEPROM.length(); pos++)
+      EEPROM.update(pos, 0);
     //Write eeprom check as last. (when all structs are written)
     writeCharArray(0,eeprom_check, sizeof(eeprom_check));
   }
+  return lost;
+}
+
+void EEPROM_Cookbook::getDefaultName(byte productIdx, char* name) {
+  strcpy(name, "Custom ");
+  itoa(productIdx+1, name+7, 10);
+}
+
+//true for a product that was never edited. (as written by prepareEEPROM)
+bool EEPROM_Cookbook::isDefaultProduct(byte productIdx) {
+  char name[PRODUCTNAME_MAX_LEN], defaultName[PRODUCTNAME_MAX_LEN];
+  readName(productIdx, name);
+  getDefaultName(productIdx, defaultName);
+  if(strcmp(name, defaultName) != 0 || readPreHeat(productIdx))
+    return false;
+  int pos = getStepAddress(productIdx, 0);
+  for(unsigned int i = 0; i < MAX_STEPS * sizeof(CookStep); i++)
+    if(EEPROM.read(pos + i) != 0) 
+      return false;
+  return true;
+}
+
+//Format 1 filled the EEPROM with products. The edited products after count() are moved 
+//to products that were never edited. Returns the number of products without room, they are printed on Serial.
+byte EEPROM_Cookbook::moveDroppedProducts() {
+  Product p;
+  byte lost = 0, freeIdx = 0;
+  int formatOneCount = (EEPROM.length() - sizeof(eeprom_check)) / productSize;
+  for(byte x = count(); x < formatOneCount; x++) {
+    if(isDefaultProduct(x)) 
+      continue;
+    readProduct(x, &p);
+    while(freeIdx < count() && !isDefaultProduct(freeIdx)) 
+      freeIdx++;
+    if(freeIdx < count()) {
+      writeProduct(freeIdx++, &p);
+      continue;
+    }
+    //lost,<name>,<preHeat>,<seconds>,<temp>,...
+    lost++;
+    Serial.print(F("lost,"));
+    Serial.print(p.name);
+    Serial.print(',');
+    Serial.print(p.preHeat);
+    for(byte s = 0; s < p.stepsCount && s < MAX_STEPS; s++) {
+      Serial.print(',');
+      Serial.print(p.steps[s].timeInSec);
+      Serial.print(',');
+      Serial.print(p.steps[s].temp);
+    }
+    Serial.println();
+  }
+  return lost;
 }
\ No newline at end of file
@@ -14,27 +14,43 @@
 
   /*
    * EEPROM STRUCTURE:
-   * Byte 0-5: AAIR01 
+   * Byte 0-5: AAIR + format version (2) + MAX_STEPS
    * Byte6-*: Product struct[]
+   * Followed by the cook history and the checkpoint. (see Eeprom_history.h, Eeprom_checkpoint.h)
    * PRODUCT STRUCTURE:
    * - Name       14 bytes
    * - PreHeat    1 byte
    * - StepCount  1 byte
    * - steps[]    4 bytes * StepCount  (8 steps = 32 bytes)
-   * TOTAL with 8 steps: 48 bytes = 21 products or 1008 bytes.  (Atmega328P has 1024 bytes)
-   * TOTAL with 5 steps: 36 bytes = 28 products or 1008 bytes.  (Atmega328P has 1024 bytes)
+   * TOTAL with 5 steps: 36 bytes per product.
+   * Atmega328P (1024 bytes): 6 bytes header + 22 products (792 bytes) + history (132 bytes) + checkpoint (93 bytes).
    * 
    */
+
+  //product fields. (flags for readFields / writeFields)
+  #define FIELD_NAME 0x0001
+  #define FIELD_PREHEAT 0x0002
+  #define FIELD_STEP(stepIdx) (0x0004 << (stepIdx))
+  #define FIELD_ALL 0xFFFF
   
   class EEPROM_Cookbook {
     
     public:
   	  EEPROM_Cookbook(int max_eeprom_bytes);
-      void prepareEEPROM(bool force = false);
-      void writeProduct(byte productIdx, Product p);
+      byte prepareEEPROM(bool force = false);
+      void writeProduct(byte productIdx, Product* p);
       void readProduct(byte productIdx, Product* p);      
+      void writeFields(byte productIdx, Product* p, unsigned int fields);
+      void readFields(byte productIdx, Product* p, unsigned int fields);
+      void writeName(byte productIdx, char* name);
+      void readName(byte productIdx, char* name);
+      void writePreHeat(byte productIdx, bool preHeat);
+      bool readPreHeat(byte productIdx);
+      void writeStep(byte productIdx, byte stepIdx, CookStep* step);
+      void readStep(byte productIdx, byte stepIdx, CookStep* step);
       bool containsData();
       int getProductAddress(byte productIdx);
+      int getStepAddress(byte productIdx, byte stepIdx);
       int count();
 		
     private:            
@@ -43,8 +59,16 @@
       //14 bytes for name (without null terminator) + 1 byte preHeat + 1 byte stepsCount + (4 bytes * steps)
       static const int productSize = (PRODUCTNAME_MAX_LEN - 1) + 2 + (sizeof(CookStep) * MAX_STEPS); 
       void writeCharArray(int address, char* text, int len);
+      //field offsets within a product
+      static const int preHeatOffset = PRODUCTNAME_MAX_LEN - 1;
+      static const int stepsCountOffset = preHeatOffset + 1;
+      static const int stepsOffset = stepsCountOffset + 1;
 
       static const byte eeprom_check[];
+      bool containsFormat(byte version);
+      void getDefaultName(byte productIdx, char* name);
+      bool isDefaultProduct(byte productIdx);
+      byte moveDroppedProducts();
   };
 
 #endif
\ No newline at end of file
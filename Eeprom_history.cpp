@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+
+#include "Arduino.h"
+#include "Eeprom_history.h" 
+#include "Eeprom_checksum.h" 
+
+EEPROM_History::EEPROM_History(int address) {
+  _address = address;
+}
+
+//stores the session in the slot after the newest record.
+void EEPROM_History::write(byte productIdx, CookSession* session) {
+  SessionRecord record;
+  byte idx = getNewestIdx();
+  unsigned int number = readRecord(idx, &record) ? record.number + 1 : 1;
+  idx = (idx + 1) % HISTORY_RECORDS;
+  
+  memset(&record, 0, sizeof(SessionRecord));
+  record.magic = HISTORY_MAGIC;
+  record.number = number;
+  record.productIdx = productIdx;
+  memcpy(&record.session, session, sizeof(CookSession));
+  record.checksum = checksum(&record);
+  EEPROM.put(_address + idx * sizeof(SessionRecord), record);
+}
+
+//reads a record by age. (0 = newest) Returns false for an empty slot.
+bool EEPROM_History::read(byte age, SessionRecord* record) {
+  if(age >= HISTORY_RECORDS) 
+    return false;
+  byte idx = (getNewestIdx() + HISTORY_RECORDS - age) % HISTORY_RECORDS;
+  return readRecord(idx, record);
+}
+
+//index of the record with the highest session number. (slot before the first slot when empty)
+byte EEPROM_History::getNewestIdx() {
+  SessionRecord record;
+  byte newestIdx = HISTORY_RECORDS - 1;
+  unsigned int newestNumber = 0;
+  for(byte x = 0; x < HISTORY_RECORDS; x++) {
+    if(readRecord(x, &record) && record.number > newestNumber) {
+      newestNumber = record.number;
+      newestIdx = x;
+    }
+  }
+  return newestIdx;
+}
+
+bool EEPROM_History::readRecord(byte idx, SessionRecord* record) {
+  EEPROM.get(_address + idx * sizeof(SessionRecord), *record);
+  return record->magic == HISTORY_MAGIC && record->checksum == checksum(record);
+}
+
+//checksum of the record data after the checksum byte.
+byte EEPROM_History::checksum(SessionRecord* record) {
+  return eepromChecksum(HISTORY_MAGIC, (byte*)record + 2, sizeof(SessionRecord) - 2);
+}
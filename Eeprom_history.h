@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+ 
+#ifndef eeprom_history_h
+  #define eeprom_history_h
+  #include "Arduino.h"
+  #include <EEPROM.h>
+  #include "FryEngine.h"
+
+  /*
+   * EEPROM STRUCTURE (starting at the given address):
+   * - records[]    33 bytes * HISTORY_RECORDS (ring buffer, oldest record is overwritten)
+   * RECORD STRUCTURE:
+   * - Magic        1 byte  (HISTORY_MAGIC)
+   * - Checksum     1 byte  (of the following bytes)
+   * - Number       2 bytes (session number, the highest number is the newest record)
+   * - ProductIdx   1 byte
+   * - Session      28 bytes (CookSession with 5 steps)
+   * TOTAL with 4 records: 132 bytes.
+   * 
+   */
+
+  #define HISTORY_RECORDS 4
+  #define HISTORY_MAGIC 0xC3
+
+  struct SessionRecord {
+    byte magic;
+    byte checksum;
+    unsigned int number;
+    byte productIdx;
+    CookSession session;
+  };
+  
+  class EEPROM_History {
+    
+    public:
+      EEPROM_History(int address);
+      void write(byte productIdx, CookSession* session);
+      bool read(byte age, SessionRecord* record);
+      static const int size = sizeof(SessionRecord) * HISTORY_RECORDS;
+      
+    private:
+      int _address;
+      byte getNewestIdx();
+      bool readRecord(byte idx, SessionRecord* record);
+      byte checksum(SessionRecord* record);
+  };
+
+#endif
@@ -9,6 +9,7 @@
 #include "Arduino.h"
 #include "Product.h"
 #include "FryEngine.h"
+#include "Clock.h"
 #include <math.h>
 
 FryEngine::FryEngine(byte heaterPin, byte fanPin, byte temperaturePin, int preHeatTimeout, callback stepCompletedCallBack) {
@@ -19,6 +20,12 @@ FryEngine::FryEngine(byte heaterPin, byte fanPin, byte temperaturePin, int preHe
   _refreshInterval = 500;
   _currentStep = 0;
   _preHeatTimeout = preHeatTimeout;
+  _heatRate = HEAT_RATE_DEFAULT;
+  _heatRateSince = 0;
+  _heaterOn = false;
+  _noRiseSince = 0;
+  _jumpSamples = 0;
+  _fault = FAULT_NONE;
   pinMode(_heaterPin,OUTPUT);
   pinMode(_fanPin,OUTPUT);
   pinMode(_temperaturePin, INPUT);
@@ -35,15 +42,30 @@ void FryEngine::setProduct(Product* product) {
   _preHeat = product->preHeat;
   //copy all steps
   for(_stepsCount = 0; _stepsCount < product->stepsCount; _stepsCount++) {  //&& _stepsCount < MAX_STEPS
-    memcpy(&_steps[_stepsCount], &product->steps[_stepsCount], 4);
+    memcpy(&_steps[_stepsCount], &product->steps[_stepsCount], sizeof(CookStep));
+    //steps stored before the temperature limit.
+    _steps[_stepsCount].temp = min(_steps[_stepsCount].temp, STEP_TEMP_MAX);
   }
 }
 
 void FryEngine::start() {
+  //never start heating on a faulty sensor.
+  if(_fault != FAULT_NONE) return;
   _currentStep = 0;
-  _runningSince = millis();
+  _runningSince = _startedOn = sysClock.getSeconds();
+  _runningSinceMillis = sysClock.getSecondMillis();
+  _isRunning = true;
   _preHeatReached = false;
   _preHeatReachedTime = 0;
+  //start a new session
+  memset(&_session, 0, sizeof(CookSession));
+  for(byte x = 0; x < _stepsCount; x++)
+    _session.programmedSeconds[x] = _steps[x].timeInSec;
+  _stepStartedOn = 0;
+  _heatRateSince = 0;
+  _heaterOnTicks = 0;
+  _fanOnTicks = 0;
+  trace('S', _currentStep);
   powerFan(getCurrentStep()->temp>0);
 }
 
@@ -52,25 +74,43 @@ void FryEngine::start(Product* product) {
   start();	
 }
 
+//resumes an interrupted cook at the given step and elapsed time.
+void FryEngine::start(Product* product, byte stepIdx, unsigned long elapsedSeconds) {
+  start(product);
+  if(!isRunning()) return;
+  _currentStep = stepIdx;
+  _runningSince = sysClock.getSeconds() - elapsedSeconds;
+  _runningSinceMillis = sysClock.getSecondMillis();
+  _stepStartedOn = elapsedSeconds; //the session starts at the resume point.
+  trace('S', _currentStep);
+  powerFan(getCurrentStep()->temp>0);
+}
+
 void FryEngine::stop() { 
+  if(isRunning()) {
+    endSession();
+    trace('E', _currentStep);
+  }
   _currentStep = 0;
   _runningSince = 0;
+  _isRunning = false;
+  _heatRateSince = 0;
   powerFan(0);
   powerHeater(0);
   _stepCompletedCallBackPtr(ENGINE_STOPPED_STEP);
 }
 
-unsigned int FryEngine::getElapsedSeconds() {
-  return _runningSince == 0 ? 0 : (millis() - _runningSince) / 1000 ;
+unsigned long FryEngine::getElapsedSeconds() {
+  return isRunning() ? sysClock.secondsSince(_runningSince, _runningSinceMillis) : 0;
 }
 
 unsigned int FryEngine::getRemainingSeconds() {
-  int allSecondsTillCurrentStep = 0;
+  long allSecondsTillCurrentStep = 0;
   if(!isRunning()) return 0;
   for (int x = 0; x < getCurrentStepIdx(); x++) {
       allSecondsTillCurrentStep += _steps[x].timeInSec;
   }
-  int remainingTime = getCurrentStep()->timeInSec - (getElapsedSeconds()-allSecondsTillCurrentStep );
+  long remainingTime = getCurrentStep()->timeInSec - ((long)getElapsedSeconds()-allSecondsTillCurrentStep );
   return remainingTime < 0 ? 0 : remainingTime;
 }
 
@@ -91,9 +131,30 @@ bool FryEngine::getPreHeat() {
 }
 
 void FryEngine::setPreHeat(bool value){
+  if(isRunning() && _preHeat && !value) {
+    _session.preHeatSeconds = sysClock.secondsSince(_startedOn);
+    trace('P', 0);
+  }
   _preHeat = value;
 }
 
+CookSession* FryEngine::getSession() {
+  return &_session;
+}
+
+//completes the metering of the running cook.
+void FryEngine::endSession() {
+  if(_preHeat)
+    _session.preHeatSeconds = sysClock.secondsSince(_startedOn);
+  //time spent in the interrupted step.
+  if(_currentStep < getStepsCount())
+    _session.stepSeconds[_currentStep] = getElapsedSeconds() - _stepStartedOn;
+  _session.stepsDone = _currentStep;
+  _session.fault = _fault;
+  _session.heaterOnSeconds = (unsigned long)_heaterOnTicks * _refreshInterval / 1000;
+  _session.fanOnSeconds = (unsigned long)_fanOnTicks * _refreshInterval / 1000;
+}
+
 byte FryEngine::getCurrentStepIdx() {
   return _currentStep;
 }
@@ -102,15 +163,64 @@ byte FryEngine::getStepsCount() {
   return _stepsCount;
 }
 
+//Get the next step that contains time. Returns the steps count when there are no steps left.
+byte FryEngine::getNextStepIdx(byte stepIdx) {
+  while(++stepIdx < getStepsCount() && getStep(stepIdx)->timeInSec==0) { }
+  return stepIdx;
+}
+
 void FryEngine::updateTemperature() {
-  int val = analogRead(_temperaturePin);
+  int val = _rawTemperature = analogRead(_temperaturePin);
+  //do not convert readings of an open or shorted sensor. (see checkSensor)
+  if(val < SENSOR_ADC_MIN || val > SENSOR_ADC_MAX) return;
   double temp;
   temp = log((100000.0/30)*((1024.0/val-1))); //100000 = 100k thermistor.
   temp = 1 / (0.001129148 + (0.000234125 + (0.0000000876741 * temp * temp ))* temp );
   temp -= 273.15;
+  _sampleTemp = constrain(temp, -99, 999);
   _temperatures[_tempIdx++ % 10] = constrain(temp, 0, 255);
 }
 
+byte FryEngine::getFault() {
+  return _fault;
+}
+
+//plausibility checks on the last sample. Returns a FAULT_* code.
+byte FryEngine::checkSensor(unsigned long now) {
+  if(_rawTemperature < SENSOR_ADC_MIN) return FAULT_SENSOR_OPEN;
+  if(_rawTemperature > SENSOR_ADC_MAX) return FAULT_SENSOR_SHORT;
+  if(_sampleTemp > SENSOR_TEMP_MAX) return FAULT_OVERHEAT;
+  //compared with the average: near 200°C one ADC count is about 3°C.
+  if(abs(_sampleTemp - getTemperature()) <= SENSOR_TEMP_MAX_JUMP)
+    _jumpSamples = 0;
+  else if(++_jumpSamples >= SENSOR_JUMP_SAMPLES) 
+    return FAULT_SENSOR_JUMP;
+  
+  //temperature must rise while the heater is on.
+  //The period restarts at a new minimum (basket opened, frozen food) and after each rise.
+  byte temp = getTemperature();
+  if(!_heaterOn) {
+    _noRiseSince = 0;
+  } else if(_noRiseSince == 0 || temp < _noRiseTemp || temp >= _noRiseTemp + NO_RISE_MIN_TEMP) {
+    _noRiseSince = now;
+    _noRiseTemp = temp;
+  } else if(now - _noRiseSince >= NO_RISE_TIMEOUT) {
+    return FAULT_NO_RISE;
+  }
+  return FAULT_NONE;
+}
+
+//cuts the heater and fan and latches the fault until reset.
+void FryEngine::fault(byte faultCode) {
+  _fault = faultCode;
+  //end the running cook. (the session records the fault)
+  if(isRunning())
+    stop();
+  powerHeater(0);
+  powerFan(0);
+  _stepCompletedCallBackPtr(ENGINE_FAULT_STEP);
+}
+
 byte FryEngine::getTemperature() {
   int totTemp = 0;
   for(int x = 0; x <10; x++) {
@@ -120,18 +230,26 @@ byte FryEngine::getTemperature() {
 }
 
 bool FryEngine::isRunning() {
-  return _runningSince > 0;
+  return _isRunning;
 }
 
 //return true to process timer event in ino script.
 bool FryEngine::timer() {
-  unsigned long refreshMillis = millis();
-  if (refreshMillis - _refreshedOn >= _refreshInterval) {
+  unsigned long refreshMillis = sysClock.getMillis();
+  if (_fault == FAULT_NONE && refreshMillis - _refreshedOn >= _refreshInterval) {
     //do refresh actions!
     _refreshedOn = refreshMillis;
     
     //update current device temperature
     updateTemperature();
+    trace('T', _rawTemperature);
+    
+    //is the sensor still plausible?
+    byte faultCode = checkSensor(refreshMillis);
+    if(faultCode != FAULT_NONE) {
+      fault(faultCode);
+      return true;
+    }
     
     //is engine running?
     if (isRunning()) {
@@ -139,8 +257,9 @@ bool FryEngine::timer() {
       //is pre heating?
       if(getPreHeat()) {
           //reset running time untill Pre Heat mode is deactivated by user.
-          _runningSince = millis();          
-          unsigned int secPassed = (refreshMillis - _preHeatReachedTime) / 1000;
+          _runningSince = sysClock.getSeconds();          
+          _runningSinceMillis = sysClock.getSecondMillis();
+          unsigned long secPassed = sysClock.secondsSince(_preHeatReachedTime);
           //stop the engine when [PreHeatTimeout] seconds passed since temperature was reached without any user interaction.
           if(_preHeatReached && secPassed >= _preHeatTimeout){
               stop();
@@ -149,7 +268,7 @@ bool FryEngine::timer() {
           //pre heat complete?
           if(!_preHeatReached && getTemperature() >= getCurrentStep()->temp){
             _preHeatReached = true;
-            _preHeatReachedTime = refreshMillis;
+            _preHeatReachedTime = sysClock.getSeconds();
             _stepCompletedCallBackPtr(PREHEAT_COMPLETE_STEP);
           }
       }
@@ -157,8 +276,10 @@ bool FryEngine::timer() {
       //Is Step complete?
       if (getRemainingSeconds() <= 0){        
         int completedStep = _currentStep;
+        _session.stepSeconds[completedStep] = getElapsedSeconds() - _stepStartedOn;
+        _stepStartedOn = getElapsedSeconds();
         //Get the next step that contains time and store the index in _currentStep.
-        while(++_currentStep < getStepsCount() && getCurrentStep()->timeInSec==0) { }
+        _currentStep = getNextStepIdx(_currentStep);
         //custom callback to ino script (eg for buzzer)
         _stepCompletedCallBackPtr(completedStep);
         //Are we trhrough all the steps?
@@ -173,12 +294,66 @@ bool FryEngine::timer() {
       }
       //check if fryer is still on temperature.
       adjustHeat();
+      //measure how fast the fryer heats up.
+      learnHeatRate(refreshMillis);
+      //session metering
+      if(_heaterOn) _heaterOnTicks++;
+      if(_fanOn) _fanOnTicks++;
     }  
     return true;
   }
   return false;
 }
 
+//returns the temperature the heater regulates to.
+//When the next step is hotter, its temperature is used as soon as the remaining time
+//of the current step is needed to heat up. (heat ahead, the step starts on temperature)
+byte FryEngine::getTargetTemperature() {
+  byte target = getCurrentStep()->temp;
+  //no heat ahead while preheating or when the fan is off. (zero temperature step)
+  if(!HEAT_AHEAD || getPreHeat() || target == 0)
+    return target;
+  byte nextStepIdx = getNextStepIdx(_currentStep);
+  if(nextStepIdx < getStepsCount()) {
+    byte nextTemp = getStep(nextStepIdx)->temp;
+    if(nextTemp > target && getRemainingSeconds() <= getHeatUpSeconds(nextTemp))
+      target = nextTemp;
+  }
+  return target;
+}
+
+//estimated seconds needed to heat up from the current temperature, based on the learned heat-up rate.
+unsigned int FryEngine::getHeatUpSeconds(byte temperature) {
+  byte currentTemp = getTemperature();
+  if(temperature <= currentTemp)
+    return 0;
+  return (temperature - currentTemp) * 100UL / _heatRate;
+}
+
+unsigned int FryEngine::getPreHeatEtaSeconds() {
+  return getHeatUpSeconds(getCurrentStep()->temp);
+}
+
+//learns the heat-up rate (1/100 °C per second) while the heater is on.
+void FryEngine::learnHeatRate(unsigned long now) {
+  if(!_heaterOn) {
+    _heatRateSince = 0;
+    return;
+  }
+  byte currentTemp = getTemperature();
+  unsigned long passed = now - _heatRateSince;
+  if(_heatRateSince != 0 && passed < HEAT_RATE_WINDOW)
+    return;
+  //only learn from a rising temperature. (a full window since the heater was switched on)
+  if(_heatRateSince != 0 && currentTemp > _heatRateTemp) {
+    unsigned int rate = (currentTemp - _heatRateTemp) * 100000UL / passed;
+    //smooth out with previous measurements.
+    _heatRate = (_heatRate * 3UL + rate) / 4;
+  }
+  _heatRateSince = now;
+  _heatRateTemp = currentTemp;
+}
+
 bool FryEngine::isOnTemperature() {
   return _isOnTemp;
 }
@@ -186,7 +361,7 @@ bool FryEngine::isOnTemperature() {
 void FryEngine::adjustHeat() {
   if(isRunning()){
     byte currentTemp = getTemperature();
-    byte prefferedTemp = getCurrentStep()->temp;
+    byte prefferedTemp = getTargetTemperature();
     //is temperature greater than the preffered temperature?
     //or was the fryer on temperature and is the current temperature still above the preffered Temperature minus the offset (-5) 
     _isOnTemp = (currentTemp >= prefferedTemp) || (_isOnTemp && currentTemp > prefferedTemp-TEMP_OFFSET_LOW);
@@ -195,9 +370,28 @@ void FryEngine::adjustHeat() {
 }
 
 void FryEngine::powerFan(bool power) {
+  //only record relay changes.
+  if(power != _fanOn)
+    trace('F', power);
+  _fanOn = power;
   digitalWrite(_fanPin, power);
 }
 
 void FryEngine::powerHeater(bool power) {
+  //only record relay changes.
+  if(power != _heaterOn)
+    trace('H', power);
+  _heaterOn = power;
   digitalWrite(_heaterPin, power);
+}
+
+//prints one trace line to Serial. (see TRACE_SERIAL)
+void FryEngine::trace(char type, int value) {
+#if TRACE_SERIAL
+  Serial.print(type);
+  Serial.print(',');
+  Serial.print(sysClock.getMillis());
+  Serial.print(',');
+  Serial.println(value);
+#endif
 }
\ No newline at end of file
@@ -16,10 +16,58 @@
   //Using zero could damage the relays. Use a value above 1
   #define TEMP_OFFSET_LOW 5
 
+  //start heating for a hotter next step before the current step ends. (1 = on, 0 = off)
+  #ifndef HEAT_AHEAD
+    #define HEAT_AHEAD 1
+  #endif
+
+  //learned heat-up rate in 1/100 °C per second. (start value before anything is learned)
+  #define HEAT_RATE_DEFAULT 100
+  //measure the heat-up rate over this period (ms) while the heater is on.
+  #define HEAT_RATE_WINDOW 5000
+
+  //record raw sensor readings, relay states and cook events to Serial. (1 = on, 0 = off)
+  //Format, one line per event: <type>,<millis>,<value>
+  //T = raw ADC value, H = heater relay, F = fan relay,
+  //S = cook started (step index), P = preheat ended by the user (0), E = cook stopped (step index).
+  #ifndef TRACE_SERIAL
+    #define TRACE_SERIAL 0
+  #endif
+
+  //sensor plausibility checks. (on every sample)
+  #define SENSOR_ADC_MIN 3         //ADC values below = open sensor
+  #define SENSOR_ADC_MAX 1020      //ADC values above = shorted sensor
+  #define SENSOR_TEMP_MAX 250      //°C, max plausible temperature
+  #define STEP_TEMP_MAX 200        //°C, max step temperature (HD9240 maximum). Must stay below SENSOR_TEMP_MAX.
+  #define SENSOR_TEMP_MAX_JUMP 15  //°C, max difference between a sample and the average temperature (5s)
+  #define SENSOR_JUMP_SAMPLES 3    //consecutive samples beyond SENSOR_TEMP_MAX_JUMP (single spikes are relay noise)
+  #define NO_RISE_TIMEOUT 60000    //ms, max heater on time without a rising temperature
+  #define NO_RISE_MIN_TEMP 2       //°C, minimal rise above the lowest temperature within NO_RISE_TIMEOUT
+
+  //fault codes (latched until reset)
+  #define FAULT_NONE 0
+  #define FAULT_SENSOR_OPEN 1
+  #define FAULT_SENSOR_SHORT 2
+  #define FAULT_OVERHEAT 3
+  #define FAULT_SENSOR_JUMP 4
+  #define FAULT_NO_RISE 5
+
   #define PREHEAT_COMPLETE_STEP -1
   #define ENGINE_STOPPED_STEP -2
+  #define ENGINE_FAULT_STEP -3
   typedef void (*callback)(int);
 
+  //metering of one cook. (from start till stop)
+  struct CookSession {
+    byte stepsDone;                         //1 byte
+    byte fault;                             //1 byte, FAULT_* code that stopped the cook
+    unsigned int preHeatSeconds;            //2 bytes
+    unsigned int heaterOnSeconds;           //2 bytes
+    unsigned int fanOnSeconds;              //2 bytes
+    unsigned int programmedSeconds[MAX_STEPS]; //2 bytes * MAX_STEPS
+    unsigned int stepSeconds[MAX_STEPS];    //2 bytes * MAX_STEPS, actual step time
+  };
+
   class FryEngine {
     
     public:
@@ -28,10 +76,11 @@
       void       setProduct(Product* product);
       void       start();
       void       start(Product* product);
+      void       start(Product* product, byte stepIdx, unsigned long elapsedSeconds);
       void       stop();
       bool       isRunning();
       bool       timer();
-      unsigned int getElapsedSeconds();
+      unsigned long getElapsedSeconds();
       unsigned int getRemainingSeconds();
       CookStep*  getStep(byte stepIdx);
       CookStep*  getCurrentStep();
@@ -43,28 +92,57 @@
       byte       getTemperature();
       bool       isOnTemperature();
       byte       resetTemperature();
+      byte       getFault();
+      CookSession* getSession();
+      byte       getTargetTemperature();
+      unsigned int getHeatUpSeconds(byte temperature);
+      unsigned int getPreHeatEtaSeconds();
      
     private:
       void       adjustHeat(); //checks if heater needs to ben on or off...   (in 'loop' function)
       void       powerFan(bool power); // fan on / off
       void       powerHeater(bool power);
       void       updateTemperature();
+      void       learnHeatRate(unsigned long now);
+      byte       getNextStepIdx(byte stepIdx);
+      void       trace(char type, int value);
+      byte       checkSensor(unsigned long now);
+      void       fault(byte faultCode);
+      void       endSession();
       byte       _heaterPin;
       byte       _fanPin;
       byte       _temperaturePin;
-      int        _preHeatTimeout;
-      int        _refreshInterval;
+      unsigned int _preHeatTimeout;
+      unsigned int _refreshInterval;
       unsigned long _refreshedOn; //timer for temperature adjustement.
-      unsigned long _runningSince; //holds the starttime. (engine running)
+      unsigned long _runningSince; //holds the starttime in seconds. (engine running)
+      unsigned int  _runningSinceMillis; //millis into the start second.
+      bool       _isRunning;
       bool       _isOnTemp;
+      bool       _heaterOn;
+      bool       _fanOn;
+      unsigned int  _heatRate; //learned heat-up rate (1/100 °C per second)
+      unsigned long _heatRateSince; //start of the current heat-up measurement.
+      byte       _heatRateTemp; //temperature at the start of the current heat-up measurement.
       byte       _temperatures[10]; //precision. (average temperature over 5s)
+      int        _rawTemperature; //last ADC value
+      int        _sampleTemp; //last sampled temperature (not averaged)
+      byte       _jumpSamples; //consecutive samples beyond SENSOR_TEMP_MAX_JUMP
+      unsigned long _noRiseSince; //start of the heater on period being checked for a rising temperature.
+      byte       _noRiseTemp; //lowest temperature since _noRiseSince
+      byte       _fault;
       byte       _tempIdx;
       bool       _preHeat;
       bool       _preHeatReached;
-      unsigned long _preHeatReachedTime;
+      unsigned long _preHeatReachedTime; //in seconds
       byte       _stepsCount;
       byte       _currentStep;
       callback   _stepCompletedCallBackPtr;
+      CookSession _session;
+      unsigned long _startedOn; //in seconds, not reset by preheat.
+      unsigned long _stepStartedOn; //elapsed seconds when the current step started.
+      unsigned int _heaterOnTicks;
+      unsigned int _fanOnTicks;
       CookStep   _steps[MAX_STEPS];
   };
 #endif
@@ -70,22 +70,26 @@ void LCD1602::printCelcius(byte temp, byte sign, bool isDeviceTemp) {
   lcd.print(buffer);
 }
 
-//Prints the time at the current position on the screen. consumes 5 digits on display!
+//Prints the time at the current position on the screen. consumes 6 chars on display! ("mm:ss ", "mmm:ss", or " 16h40" from 1000 minutes on)
 void LCD1602::printTimeOnLcd(int &minutes, int &seconds) {
   char time[7];
-  sprintf(time, "%02d:%02d" , minutes, seconds);
+  //hours and minutes from 1000 minutes on. (calcTime limits the minutes to 546h07)
+  if(minutes >= 1000)
+    sprintf(time, "%3dh%02d" , min(minutes / 60, 999), (unsigned int)minutes % 60);
+  else
+    sprintf(time, "%02d:%02d" , constrain(minutes, 0, 999), (unsigned int)seconds % 60);
   lcd.print(time);  
   if(minutes < 100) lcd.print(' ');
 }
 
-void LCD1602::printTimerTime(unsigned int elapsedSeconds) {  
+void LCD1602::printTimerTime(unsigned long elapsedSeconds) {  
   lcd.setCursor(4,0); 
   printTime(elapsedSeconds, 0);
 }
 
 void  LCD1602::printTime(long allSeconds, bool inEditMode) {
   //calc time and print on screen
-  int seconds, minutes; //TODO: no hours yet... 
+  int seconds, minutes; //hours are printed by printTimeOnLcd.
   calcTime(allSeconds,minutes,seconds);
   if(inEditMode && menuBlinkItem)
     clearChars(6);
@@ -95,9 +99,8 @@ void  LCD1602::printTime(long allSeconds, bool inEditMode) {
 
 //calc time, returns minutes and seconds as references.
 void LCD1602::calcTime(long allSeconds, int &outM, int &outS) {
-  outS = allSeconds; //store seconds
-  outM = (outS / 60); //calc minutes (decimal numbers are converted to round number (lower bound))
-  outS = outS - (outM * 60); //remove the minutes from s;
+  outM = min(allSeconds / 60, 32767L); //calc minutes (decimal numbers are converted to round number (lower bound)), int limit
+  outS = allSeconds - (outM * 60L); //remove the minutes from s;
 }
 
 void  LCD1602::printTemperature(byte temp) {
@@ -147,7 +150,7 @@ void LCD1602::printProductLine(char* product, byte deviceTemperature, byte heati
   printDeviceTemperature(deviceTemperature, heatingSign);   
 }
 
-void LCD1602::printRunLine(unsigned int elapsedSeconds, byte temperature, byte heatingSign){  
+void LCD1602::printRunLine(unsigned long elapsedSeconds, byte temperature, byte heatingSign){  
   //erase productname.
   lcd.setCursor(0,0);
   clearChars(4);
@@ -157,6 +160,21 @@ void LCD1602::printRunLine(unsigned int elapsedSeconds, byte temperature, byte h
   printDeviceTemperature(temperature, heatingSign);   
 }
 
+/*
+  prints the estimated time to reach the preheat temperature. Format:
+  ------------------
+  |ETA 02:35 >180°C|
+  ------------------
+*/
+void LCD1602::printPreHeatLine(unsigned int etaSeconds, byte temperature, byte heatingSign){
+  lcd.setCursor(0,0);
+  printLine(F("ETA"),4);
+  //print estimated time
+  printTimerTime(etaSeconds);
+  //print device temp
+  printDeviceTemperature(temperature, heatingSign);
+}
+
 void LCD1602::printMenu(char item[PRODUCTNAME_MAX_LEN]) {
   lcd.setCursor(0,0);
   printLine(F("Choose product:"),16);  
@@ -165,6 +183,22 @@ void LCD1602::printMenu(char item[PRODUCTNAME_MAX_LEN]) {
   printLine(item,14);
 }
 
+/*
+  prints the (latched) error screen. Format:
+  ------------------
+  |!ERROR! HEAT OFF|
+  |E1 Reset fryer  |
+  ------------------
+*/
+void LCD1602::printError(byte errorCode) {
+  lcd.clear();
+  lcd.print(F("!ERROR! HEAT OFF"));
+  lcd.setCursor(0,1);
+  lcd.print('E');
+  lcd.print(errorCode);
+  lcd.print(F(" Reset fryer"));
+}
+
 void LCD1602::changeChar(char value, byte x, byte y) {
   lcd.setCursor(x,y);
   lcd.print(value);
@@ -196,6 +230,15 @@ void LCD1602::printSaveDialog(short option = 0) {
   printDialogOption(option == DIALOG_RESULT_ABORT, F("ABORT"));  
 }
 
+void LCD1602::printResumeDialog(short option) {
+  lcd.setCursor(0,0);
+  printLine(F("Resume cooking?"),16);
+  lcd.setCursor(0,1);
+  printDialogOption(option == DIALOG_RESULT_YES, F("YES"));
+  printDialogOption(option == DIALOG_RESULT_NO, F("NO"));
+  clearChars(7);
+}
+
 void LCD1602::printDialogOption(bool checked, const __FlashStringHelper* text) {
   lcd.print(checked ? '<' : ' ');
   lcd.print(text);
@@ -18,14 +18,16 @@
   //enum screens
   #define SCREEN_MENU 0
   #define SCREEN_MENU_SAVE 1
-  #define SCREEN_PRODUCT 2
-  #define SCREEN_RUNNING 3
-  #define SCREEN_EDIT_NAME 4
-  #define SCREEN_EDIT_STEP 5
-  #define SCREEN_EDIT_BEEP 6
-  #define SCREEN_EDIT_TIME 7
-  #define SCREEN_EDIT_TEMP 8
-  #define SCREEN_EDIT_PREHEAT 9
+  #define SCREEN_RESUME 2
+  #define SCREEN_PRODUCT 3
+  #define SCREEN_RUNNING 4
+  #define SCREEN_EDIT_NAME 5
+  #define SCREEN_EDIT_STEP 6
+  #define SCREEN_EDIT_BEEP 7
+  #define SCREEN_EDIT_TIME 8
+  #define SCREEN_EDIT_TEMP 9
+  #define SCREEN_EDIT_PREHEAT 10
+  #define SCREEN_ERROR 11
 
   #define DIALOG_RESULT_ABORT -1
   #define DIALOG_RESULT_NO 0
@@ -38,11 +40,14 @@
       LCD1602(LiquidCrystal_I2C& _lcd);
       void init();
       void lcdPowerMode(bool on);
-      void printRunLine(unsigned int elapsedSeconds, byte temperature, byte heatingSign);
+      void printRunLine(unsigned long elapsedSeconds, byte temperature, byte heatingSign);
+      void printPreHeatLine(unsigned int etaSeconds, byte temperature, byte heatingSign);
       void printStepLine(byte stepIdx, long secToGo, byte temp, bool beep);
       void printProductLine(char* product, byte deviceTemperature, byte heatingSign);
       void printSaveDialog(short option = 0);
+      void printResumeDialog(short option = 0);
       void printMenu(char item[PRODUCTNAME_MAX_LEN]);
+      void printError(byte errorCode);
       //void openMenu();
       void changeChar(char value, byte x, byte y);
       bool menuBlinkItem;
@@ -53,7 +58,7 @@
       LiquidCrystal_I2C &lcd;
       void printDeviceTemperature(byte temperature, byte temperatureSign);
       void printCelcius(byte temp, byte sign, bool isDeviceTemp);
-      void printTimerTime(unsigned int elapsedSeconds);
+      void printTimerTime(unsigned long elapsedSeconds);
       void printTimeOnLcd(int &minutes, int &seconds);
       void printTime(long allSeconds, bool inEditMode);
       void calcTime(long allSeconds, int &outM, int &outS);
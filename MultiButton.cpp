@@ -5,6 +5,7 @@
 
 #include "Arduino.h"
 #include "MultiButton.h"
+#include "Clock.h"
 
 void MultiButton::setup(byte buttonPin) {
   this->gpioPin = buttonPin;
@@ -13,26 +14,27 @@ void MultiButton::setup(byte buttonPin) {
 
 byte MultiButton::check() {    
    byte event = 0;
+   unsigned long now = sysClock.getMillis();
    buttonVal = digitalRead(gpioPin);
    // Button pressed down
-   if (buttonVal == LOW && buttonLast == HIGH && (millis() - upTime) > debounce)
+   if (buttonVal == LOW && buttonLast == HIGH && (now - upTime) > debounce)
    {
-       downTime = millis();
+       downTime = now;
        ignoreUp = false;
        waitForUp = false;
        singleOK = true;
        holdEventPast = false;
        longHoldEventPast = false;
-       if ((millis()-upTime) < DCgap && DConUp == false && DCwaiting == true)  DConUp = true;
+       if ((now-upTime) < DCgap && DConUp == false && DCwaiting == true)  DConUp = true;
        else  DConUp = false;
        DCwaiting = false;
    }
    // Button released
-   else if (buttonVal == HIGH && buttonLast == LOW && (millis() - downTime) > debounce)
+   else if (buttonVal == HIGH && buttonLast == LOW && (now - downTime) > debounce)
    {        
        if (not ignoreUp)
        {
-           upTime = millis();
+           upTime = now;
            if (DConUp == false) DCwaiting = true;
            else
            {
@@ -44,13 +46,13 @@ byte MultiButton::check() {
        }
    }
    // Test for normal click event: DCgap expired
-   if ( buttonVal == HIGH && (millis()-upTime) >= DCgap && DCwaiting == true && DConUp == false && singleOK == true && event != 2)
+   if ( buttonVal == HIGH && (now-upTime) >= DCgap && DCwaiting == true && DConUp == false && singleOK == true && event != 2)
    {
        event = BTN_SINGLE_CLICK;
        DCwaiting = false;
    }
    // Test for hold
-   if (buttonVal == LOW && (millis() - downTime) >= holdTime) {
+   if (buttonVal == LOW && (now - downTime) >= holdTime) {
        // Trigger "normal" hold
        if (not holdEventPast)
        {
@@ -59,11 +61,11 @@ byte MultiButton::check() {
            ignoreUp = true;
            DConUp = false;
            DCwaiting = false;
-           //downTime = millis();
+           //downTime = now;
            holdEventPast = true;
        }
        /* Trigger "long" hold
-       if ((millis() - downTime) >= longHoldTime)
+       if ((now - downTime) >= longHoldTime)
        {
            if (not longHoldEventPast)
            {
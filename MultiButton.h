@@ -16,10 +16,10 @@
     private:
       byte gpioPin;     
       // Button timing variables
-      int debounce = 50;          // ms debounce period to prevent flickering when pressing or releasing the button
-      int DCgap = 300;            // max ms between clicks for a double click event
-      int holdTime = 750;        // ms hold period: how long to wait for press+hold event
-      int longHoldTime = 20000;    // ms long hold period: how long to wait for press+hold even    
+      unsigned int debounce = 50;          // ms debounce period to prevent flickering when pressing or releasing the button
+      unsigned int DCgap = 300;            // max ms between clicks for a double click event
+      unsigned int holdTime = 750;        // ms hold period: how long to wait for press+hold event
+      unsigned int longHoldTime = 20000;    // ms long hold period: how long to wait for press+hold even    
       // Button variables
       boolean buttonVal = HIGH;   // value read from button
       boolean buttonLast = HIGH;  // buffered value of the button's previous state
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+
+/*
+ * Host stand-in for the Arduino core. Only what the sketch classes use.
+ * Time, analog inputs and pin outputs are plain variables, driven by the host tools.
+ */
+#ifndef Arduino_h
+  #define Arduino_h
+  #include <stdint.h>
+  #include <stdlib.h>
+  #include <stdio.h>
+  #include <string.h>
+  #include <math.h>
+
+  typedef uint8_t byte;
+  typedef bool boolean;
+
+  #define HIGH 1
+  #define LOW 0
+  #define INPUT 0
+  #define OUTPUT 1
+  #define INPUT_PULLUP 2
+  #define A1 15
+  #define HOST_PINS 20
+
+  #define B00010 2
+  #define B00100 4
+  #define B01010 10
+  #define B01110 14
+  #define B10001 17
+  #define B10101 21
+  #define B11111 31
+
+  #define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+  #ifndef min
+    #define min(a,b) ((a)<(b)?(a):(b))
+    #define max(a,b) ((a)>(b)?(a):(b))
+  #endif
+
+  class __FlashStringHelper;
+  #define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+  //simulated hardware state
+  extern unsigned long hostMillis;
+  extern int hostAnalog[HOST_PINS];
+  extern byte hostPins[HOST_PINS];
+
+  unsigned long millis();
+  void delay(unsigned long ms);
+  int analogRead(byte pin);
+  int digitalRead(byte pin);
+  void digitalWrite(byte pin, byte value);
+  void pinMode(byte pin, byte mode);
+  char* itoa(int value, char* str, int base);
+
+  //Serial output goes here, NULL = discarded. (stdout by default)
+  extern FILE* hostSerial;
+
+  class HardwareSerial {
+    public:
+      size_t print(const char* text);
+      size_t print(const __FlashStringHelper* text);
+      size_t print(char c);
+      size_t print(long value);
+      size_t print(unsigned long value);
+      size_t print(int value) { return print((long)value); }
+      size_t print(unsigned int value) { return print((unsigned long)value); }
+      size_t print(byte value) { return print((unsigned long)value); }
+      size_t println();
+      template<typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+  };
+  extern HardwareSerial Serial;
+#endif
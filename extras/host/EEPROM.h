@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+
+//Host stand-in for the Arduino EEPROM library. (1024 bytes, counts reads and writes)
+#ifndef EEPROM_h
+  #define EEPROM_h
+  #include "Arduino.h"
+
+  class EEPROMClass;
+  
+  struct EERef {
+    EEPROMClass* eeprom;
+    int index;
+    operator uint8_t() const;
+    EERef& operator=(uint8_t value);
+    EERef& update(uint8_t value);
+  };
+
+  class EEPROMClass {
+    public:
+      uint8_t data[1024];
+      unsigned long reads;
+      unsigned long writes;
+      uint8_t read(int idx) { reads++; return data[idx]; }
+      void write(int idx, uint8_t value) { writes++; data[idx] = value; }
+      void update(int idx, uint8_t value) { if(read(idx) != value) write(idx, value); }
+      EERef operator[](int idx) { EERef ref = { this, idx }; return ref; }
+      uint16_t length() { return sizeof(data); }
+      template<typename T> T& get(int idx, T& t) {
+        byte* ptr = (byte*)&t;
+        for(int x = 0; x < (int)sizeof(T); x++) ptr[x] = read(idx + x);
+        return t;
+      }
+      template<typename T> const T& put(int idx, const T& t) {
+        const byte* ptr = (const byte*)&t;
+        for(int x = 0; x < (int)sizeof(T); x++) update(idx + x, ptr[x]);
+        return t;
+      }
+  };
+
+  inline EERef::operator uint8_t() const { return eeprom->read(index); }
+  inline EERef& EERef::operator=(uint8_t value) { eeprom->write(index, value); return *this; }
+  inline EERef& EERef::update(uint8_t value) { eeprom->update(index, value); return *this; }
+
+  extern EEPROMClass EEPROM;
+#endif
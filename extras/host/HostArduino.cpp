@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+
+#include "Arduino.h"
+#include "EEPROM.h"
+
+unsigned long hostMillis = 0;
+int hostAnalog[HOST_PINS] = {};
+byte hostPins[HOST_PINS] = {};
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+
+unsigned long millis() { return hostMillis; }
+void delay(unsigned long ms) { hostMillis += ms; }
+int analogRead(byte pin) { return hostAnalog[pin]; }
+int digitalRead(byte pin) { return hostPins[pin]; }
+void digitalWrite(byte pin, byte value) { hostPins[pin] = value; }
+void pinMode(byte pin, byte mode) { if(mode == INPUT_PULLUP) hostPins[pin] = HIGH; }
+
+char* itoa(int value, char* str, int base) {
+  sprintf(str, "%d", value);
+  return str;
+}
+
+FILE* hostSerial = stdout;
+
+size_t HardwareSerial::print(const char* text) { return hostSerial ? fprintf(hostSerial, "%s", text) : 0; }
+size_t HardwareSerial::print(const __FlashStringHelper* text) { return print((const char*)text); }
+size_t HardwareSerial::print(char c) { return hostSerial ? fprintf(hostSerial, "%c", c) : 0; }
+size_t HardwareSerial::print(long value) { return hostSerial ? fprintf(hostSerial, "%ld", value) : 0; }
+size_t HardwareSerial::print(unsigned long value) { return hostSerial ? fprintf(hostSerial, "%lu", value) : 0; }
+size_t HardwareSerial::println() { return print('\n'); }
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *   
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree. 
+ */
+
+//Host stand-in for the LiquidCrystal_I2C library. Keeps the 16x2 screen in memory.
+#ifndef LiquidCrystal_I2C_h
+  #define LiquidCrystal_I2C_h
+  #include "Arduino.h"
+
+  class LiquidCrystal_I2C {
+    public:
+      LiquidCrystal_I2C(byte address, byte cols, byte rows) { clear(); }
+      char screen[2][17];
+      void begin(byte cols, byte rows) { }
+      void createChar(byte location, byte charmap[]) { }
+      void backlight() { }
+      void setBacklight(byte value) { }
+      void on() { }
+      void off() { }
+      void blink() { }
+      void noBlink() { }
+      void clear() { memset(screen, ' ', sizeof(screen)); screen[0][16] = screen[1][16] = 0; _x = _y = 0; }
+      void setCursor(byte x, byte y) { _x = x; _y = y; }
+      size_t write(byte c) { if(_x < 16 && _y < 2) screen[_y][_x] = c; _x++; return 1; }
+      size_t print(char c) { return write(c); }
+      size_t print(const char* text) { size_t n = 0; while(*text) n += write(*text++); return n; }
+      size_t print(const __FlashStringHelper* text) { return print((const char*)text); }
+      size_t print(long value) { char buffer[12]; sprintf(buffer, "%ld", value); return print(buffer); }
+      size_t print(int value) { return print((long)value); }
+      size_t print(byte value) { return print((long)value); }
+    private:
+      byte _x;
+      byte _y;
+  };
+#endif
@@ -0,0 +1 @@
+//Host stand-in for the Arduino Wire library. (not used on the host)
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ * Host half of the benchmarks: wall time of the hot paths measured by runBenchmarks() (Airfryer.ino).
+ * Only relative numbers between commits are meaningful, the cycle counts on the ATmega328P are the reference.
+ * readRotaryPosition lives in the sketch and is only measured on the target.
+ *
+ * Usage: fryer_bench [results.csv]   (stdout without a file)
+ * CSV output, one line per benchmark:
+ * name,iterations,ns_per_call
+ */
+
+#include <chrono>
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "LiquidCrystal_I2C.h"
+#include "Clock.h"
+#include "FryEngine.h"
+#include "MultiButton.h"
+#include "LCD1602.h"
+#include "Eeprom_cookbook.h"
+
+#define HEATER_PIN 8
+#define FAN_PIN 7
+#define SENSOR_PIN A1
+#define BUTTON_PIN 2
+
+//more iterations than on the target: the host clock needs longer runs.
+#define HOST_ITERATIONS 100000
+
+typedef std::chrono::steady_clock BenchClock;
+
+FILE* out = stdout;
+volatile long sink = 0; //keeps the compiler from dropping results.
+
+void report(const char* name, long iterations, BenchClock::duration elapsed) {
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  fprintf(out, "%s,%ld,%.1f\n", name, iterations, ns / iterations);
+}
+
+//measures [code] [iterations] times and writes the nanoseconds per call.
+#define BENCHMARK(name, iterations, code) \
+  do { \
+    BenchClock::time_point benchStart = BenchClock::now(); \
+    for(long benchIdx = 0; benchIdx < (iterations); benchIdx++) { code; } \
+    report(name, iterations, BenchClock::now() - benchStart); \
+  } while(0)
+
+void benchmarkCallBack(int stepIdx) { }
+
+int main(int argc, char** argv) {
+  if(argc > 1 && !(out = fopen(argv[1], "w"))) {
+    fprintf(stderr, "cannot open %s\n", argv[1]);
+    return 2;
+  }
+  FryEngine engine(HEATER_PIN, FAN_PIN, SENSOR_PIN, 300, &benchmarkCallBack);
+  MultiButton button;
+  LiquidCrystal_I2C lcd(0x27, 16, 2);
+  LCD1602 screen(lcd);
+  EEPROM_Cookbook cookbook(EEPROM.length());
+  Product product = { "Benchmark", 0, MAX_STEPS }; //zero temperature: heater and fan stay off.
+  for(byte x = 0; x < MAX_STEPS; x++)
+    product.steps[x].timeInSec = 600;
+
+  hostAnalog[SENSOR_PIN] = 500;
+  button.setup(BUTTON_PIN);
+  cookbook.prepareEEPROM();
+  sysClock.tick();
+  engine.start(&product);
+  fprintf(out, "name,iterations,ns_per_call\n");
+
+  //10x updateTemperature + getTemperature
+  BENCHMARK("FryEngine::resetTemperature", HOST_ITERATIONS / 10, engine.resetTemperature());
+  BENCHMARK("FryEngine::getTemperature", HOST_ITERATIONS, sink += engine.getTemperature());
+  BENCHMARK("FryEngine::getRemainingSeconds", HOST_ITERATIONS, sink += engine.getRemainingSeconds());
+
+  //engine tick (every 500ms), the clock is advanced outside the measurement.
+  BenchClock::duration ticks = BenchClock::duration::zero();
+  for(long x = 0; x < HOST_ITERATIONS / 10; x++) {
+    hostMillis += 500;
+    sysClock.tick();
+    BenchClock::time_point tickStart = BenchClock::now();
+    engine.timer();
+    ticks += BenchClock::now() - tickStart;
+    //stay in the first step.
+    if(x % 1000 == 999) engine.start(&product);
+  }
+  report("FryEngine::timer(tick)", HOST_ITERATIONS / 10, ticks);
+
+  //loop pass without engine tick
+  sysClock.tick();
+  BENCHMARK("FryEngine::timer(idle)", HOST_ITERATIONS, sink += engine.timer());
+  BENCHMARK("MultiButton::check", HOST_ITERATIONS, sink += button.check());
+  BENCHMARK("LCD1602::printStepLine", HOST_ITERATIONS / 10, screen.printStepLine(0, 600, 180, true));
+  BENCHMARK("LCD1602::printRunLine", HOST_ITERATIONS / 10, screen.printRunLine(125, 180, '>'));
+  BENCHMARK("EEPROM_Cookbook::readProduct", HOST_ITERATIONS / 10, cookbook.readProduct(0, &product));
+
+  engine.stop();
+  if(out != stdout) fclose(out);
+  return 0;
+}
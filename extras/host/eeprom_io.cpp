@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ * Counts the EEPROM byte reads and writes of saving and discarding an edited product.
+ * The FIELD_ALL cases are the full product read/write of the sketch before the dirty fields were tracked.
+ * On the host an int is 4 bytes (CookStep = 8 bytes instead of 4), compare the cases with each other.
+ *
+ * Usage: eeprom_io   (exit code 1 when saving or discarding the dirty fields is not cheaper than FIELD_ALL)
+ * CSV output, one line per case:
+ * name,reads,writes
+ */
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "Eeprom_cookbook.h"
+
+EEPROM_Cookbook cookbook(EEPROM.length());
+Product product;
+
+struct Count {
+  unsigned long reads;
+  unsigned long writes;
+};
+
+//prepares product 0 with one edited step temperature (or name) in memory.
+void edit(bool name) {
+  cookbook.readProduct(0, &product);
+  if(name) strcpy(product.name, "Fries");
+  else product.steps[2].temp += 10;
+}
+
+//runs one save or discard and prints its EEPROM access.
+Count count(const char* name, bool editName, bool save, unsigned int fields) {
+  Count result;
+  edit(editName);
+  EEPROM.reads = EEPROM.writes = 0;
+  if(save) cookbook.writeFields(0, &product, fields);
+  else cookbook.readFields(0, &product, fields);
+  result.reads = EEPROM.reads;
+  result.writes = EEPROM.writes;
+  printf("%s,%lu,%lu\n", name, result.reads, result.writes);
+  //back to the stored product for the next case.
+  cookbook.prepareEEPROM(true);
+  return result;
+}
+
+int main() {
+  cookbook.prepareEEPROM(true);
+  printf("name,reads,writes\n");
+  Count saveAll      = count("save step (FIELD_ALL)", false, true, FIELD_ALL);
+  Count saveStep     = count("save step (dirty)", false, true, FIELD_STEP(2));
+  Count saveNameAll  = count("save name (FIELD_ALL)", true, true, FIELD_ALL);
+  Count saveName     = count("save name (dirty)", true, true, FIELD_NAME);
+  Count discardAll   = count("discard step (FIELD_ALL)", false, false, FIELD_ALL);
+  Count discardStep  = count("discard step (dirty)", false, false, FIELD_STEP(2));
+
+  //both ways write the changed bytes only, the dirty fields read less.
+  bool cheaper = saveStep.reads < saveAll.reads && saveStep.writes <= saveAll.writes
+              && saveName.reads < saveNameAll.reads && saveName.writes <= saveNameAll.writes
+              && discardStep.reads < discardAll.reads;
+  if(!cheaper) printf("FAILED: saving or discarding the dirty fields is not cheaper than FIELD_ALL\n");
+  return cheaper ? 0 : 1;
+}
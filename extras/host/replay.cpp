@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2022, Vincent Bloemen (VinzzB)
+ * All rights reserved.
+ *
+ * This source code is licensed under the Apache 2.0 license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ * Runs FryEngine on the host and reports control metrics.
+ *
+ * Replay (-t): feeds the raw sensor values of a recorded trace (see TRACE_SERIAL) back through analogRead.
+ *              The recorded cook events (start, preheat end, stop) drive the engine at their recorded time.
+ *              The recorded heater relay is compared with the decisions of this engine version. (open loop)
+ * Simulation:  without -t, a simple two-node fryer model (heating coil + air) responds to the relays. (closed loop)
+ *              The cook starts after 1s, -o writes the trace of the engine itself.
+ *
+ * Usage: fryer_replay [-t trace.csv] [-o trace.csv] [-p] [-b baseline.txt] [-w baseline.txt] [-f fault@seconds [-l ms]] <seconds>:<temp> ...
+ *   -t  replay a recorded trace
+ *   -o  write the trace of a simulation (TRACE_SERIAL output)
+ *   -p  preheat (the preheat stage is ended as soon as the temperature is reached)
+ *   -b  compare with a baseline, exit code 1 on a regression
+ *   -w  write the metrics as a new baseline
+ *   -f  simulation only, sensor fault from the given time on:
+ *       open (ADC 0), short (ADC 1023), freeze (ADC stays at its last value) or spike (relay noise, one sample every 5s is 8 counts off)
+ *       Reports the detection latency, exit code 1 when the engine latches an other fault than expected. (none for spike)
+ *   -l  max detection latency (ms) of the -f fault, exit code 1 when it is exceeded
+ */
+
+#include "Arduino.h"
+#include "Clock.h"
+#include "FryEngine.h"
+#include "Product.h"
+
+#define HEATER_PIN 8
+#define FAN_PIN 7
+#define SENSOR_PIN A1
+
+#define SIM_AMBIENT 20.0
+#define SIM_MAX_SECONDS 7200
+
+struct Metric {
+  const char* name;
+  int better; //1 = higher is better, -1 = lower is better, 0 = must match the baseline
+  double tolerance; //allowed regression (or difference)
+  double value;
+};
+
+enum { OVERSHOOT, UNDERSHOOT, TIME_AT_TEMP, HEATER_SWITCHES, FAN_SWITCHES, HEATER_ON, HEATER_MISMATCH, FAULT, METRICS_COUNT };
+
+Metric metrics[METRICS_COUNT] = {
+  { "overshoot_c",         -1, 1.0, 0 },
+  { "undershoot_c",        -1, 1.0, 0 },
+  { "time_at_temp_s",       1, 5.0, 0 },
+  { "heater_switches",     -1, 2.0, 0 },
+  { "fan_switches",         0, 0.0, 0 }, //one switch less = a missed start or stop
+  { "heater_on_s",         -1, 10.0, 0 },
+  { "heater_mismatch_ticks", -1, 4.0, 0 },
+  { "fault",                0, 0.0, 0 }
+};
+
+/* ===== FAULT INJECTION ===== */
+
+enum { INJECT_NONE, INJECT_OPEN, INJECT_SHORT, INJECT_FREEZE, INJECT_SPIKE };
+const char* injectNames[] = { "none", "open", "short", "freeze", "spike" };
+const byte injectFaults[] = { FAULT_NONE, FAULT_SENSOR_OPEN, FAULT_SENSOR_SHORT, FAULT_NO_RISE, FAULT_NONE };
+
+byte injectType = INJECT_NONE;
+unsigned long injectAt = 0; //ms
+unsigned long faultAt = 0; //ms, when the engine latched a fault.
+int frozenRaw = -1;
+
+//applies the injected sensor fault to the simulated ADC value.
+int inject(int raw) {
+  if(injectType == INJECT_NONE || hostMillis < injectAt) return raw;
+  switch(injectType) {
+    case INJECT_OPEN:   return 0;
+    case INJECT_SHORT:  return 1023;
+    case INJECT_FREEZE: return frozenRaw < 0 ? frozenRaw = raw : frozenRaw;
+    default:            return hostMillis % 5000 < 500 ? raw - 8 : raw; //one engine tick every 5s.
+  }
+}
+
+bool preHeatReached = false;
+
+void engineCallBack(int stepIdx) {
+  if(stepIdx == PREHEAT_COMPLETE_STEP)
+    preHeatReached = true;
+}
+
+FryEngine engine(HEATER_PIN, FAN_PIN, SENSOR_PIN, 300, &engineCallBack);
+
+//same conversion as FryEngine::updateTemperature
+double tempFromAdc(int val) {
+  double temp = log((100000.0/30)*((1024.0/val-1)));
+  temp = 1 / (0.001129148 + (0.000234125 + (0.0000000876741 * temp * temp ))* temp );
+  return temp - 273.15;
+}
+
+//inverse of tempFromAdc. (temperature rises with the ADC value)
+int adcFromTemp(double temp) {
+  int low = 1, high = 1022;
+  while(low < high) {
+    int mid = (low + high) / 2;
+    if(tempFromAdc(mid) < temp) low = mid + 1;
+    else high = mid;
+  }
+  return low;
+}
+
+/* ===== METRICS ===== */
+
+byte lastHeater = 0, lastFan = 0;
+int  metricStep = -1;
+bool stepReached = false;
+
+//called after every engine tick (500ms) while running.
+void measure(int raw) {
+  byte heater = hostPins[HEATER_PIN], fan = hostPins[FAN_PIN];
+  if(heater != lastHeater) metrics[HEATER_SWITCHES].value++;
+  if(fan != lastFan) metrics[FAN_SWITCHES].value++;
+  lastHeater = heater;
+  lastFan = fan;
+  if(heater) metrics[HEATER_ON].value += 0.5;
+  if(!engine.isRunning()) return;
+
+  double temp = tempFromAdc(raw);
+  int setpoint = engine.getCurrentStep()->temp;
+  if(setpoint == 0) return;
+  if(engine.getCurrentStepIdx() != metricStep) {
+    metricStep = engine.getCurrentStepIdx();
+    stepReached = false;
+  }
+  stepReached |= temp >= setpoint;
+  //above the step temperature, or above a hotter heat ahead target.
+  int maxTemp = max(setpoint, (int)engine.getTargetTemperature());
+  if(temp - maxTemp > metrics[OVERSHOOT].value) metrics[OVERSHOOT].value = temp - maxTemp;
+  if(stepReached && !engine.getPreHeat() && setpoint - temp > metrics[UNDERSHOOT].value) metrics[UNDERSHOOT].value = setpoint - temp;
+  if(!engine.getPreHeat() && fabs(temp - setpoint) <= TEMP_OFFSET_LOW) metrics[TIME_AT_TEMP].value += 0.5;
+}
+
+//ends the preheat stage as soon as it is reached. (user click)
+void userActions() {
+  if(preHeatReached && engine.getPreHeat())
+    engine.setPreHeat(false);
+}
+
+void tick(int raw) {
+  hostAnalog[SENSOR_PIN] = raw;
+  sysClock.tick();
+}
+
+/* ===== REPLAY ===== */
+
+Product program = { "Host", 0, 0 };
+
+//starts the program as recorded. (resumed cooks start at the beginning of the step)
+void startProgram(byte stepIdx) {
+  unsigned long elapsedSeconds = 0;
+  for(byte x = 0; x < stepIdx && x < program.stepsCount; x++)
+    elapsedSeconds += program.steps[x].timeInSec;
+  if(stepIdx == 0) engine.start(&program);
+  else engine.start(&program, stepIdx, elapsedSeconds);
+}
+
+//The user actions of the recording (S, P, E) drive the engine, T lines drive its ticks.
+int replay(const char* traceFile) {
+  FILE* trace = fopen(traceFile, "r");
+  if(!trace) { fprintf(stderr, "cannot open %s\n", traceFile); return 2; }
+  char type;
+  unsigned long time;
+  int value, recordedHeater = 0, tickHeater = -1;
+  bool booted = false;
+  hostSerial = NULL; //the trace of this engine is not needed.
+  while(fscanf(trace, " %c,%lu,%d", &type, &time, &value) == 3) {
+    hostMillis = time;
+    sysClock.tick();
+    if(type == 'H') recordedHeater = value;
+    if(type == 'S') startProgram(value);
+    if(type == 'P') engine.setPreHeat(false);
+    if(type == 'E' && engine.isRunning()) engine.stop();
+    if(type != 'T') continue;
+    //the relay lines of a tick follow its sensor line: compare the previous tick now.
+    if(tickHeater >= 0 && tickHeater != recordedHeater) metrics[HEATER_MISMATCH].value++;
+    tickHeater = -1;
+    tick(value);
+    //the sensor average is filled at boot.
+    if(!booted) engine.resetTemperature();
+    booted = true;
+    if(engine.timer()) {
+      measure(value);
+      tickHeater = hostPins[HEATER_PIN];
+    }
+  }
+  if(tickHeater >= 0 && tickHeater != recordedHeater) metrics[HEATER_MISMATCH].value++;
+  fclose(trace);
+  return 0;
+}
+
+/* ===== SIMULATION ===== */
+
+//The cook starts after two idle ticks, like a device trace recorded from boot.
+#define SIM_START_MS 1000
+
+int simulate(const char* traceFile) {
+  FILE* trace = traceFile ? fopen(traceFile, "w") : NULL;
+  double coil = SIM_AMBIENT, air = SIM_AMBIENT;
+  bool started = false;
+  //the engine writes the trace. (TRACE_SERIAL)
+  hostSerial = trace;
+  tick(adcFromTemp(air));
+  engine.resetTemperature();
+  for(hostMillis = 10; hostMillis < SIM_MAX_SECONDS * 1000UL && (!started || engine.isRunning()); hostMillis += 10) {
+    //10ms model step: the coil heats up and warms the air, the fan moves the heat to the food/basket.
+    double dt = 0.01;
+    double airFlow = hostPins[FAN_PIN] ? 1.0 : 0.3;
+    coil += dt * ((hostPins[HEATER_PIN] ? 25.0 : 0) - 0.2 * airFlow * (coil - air) - 0.002 * (coil - SIM_AMBIENT));
+    air  += dt * (0.008 * airFlow * (coil - air) - 0.004 * (air - SIM_AMBIENT));
+    int raw = inject(adcFromTemp(air));
+    tick(raw);
+    //same order as the sketch loop: engine tick, then user interaction.
+    if(engine.timer()) {
+      if(engine.getFault() != FAULT_NONE && faultAt == 0) faultAt = hostMillis;
+      measure(raw);
+    }
+    if(!started && hostMillis >= SIM_START_MS) {
+      engine.start();
+      started = true;
+    }
+    userActions();
+  }
+  hostSerial = stdout;
+  if(trace) fclose(trace);
+  return 0;
+}
+
+/* ===== BASELINE ===== */
+
+void writeMetrics(FILE* out) {
+  for(int x = 0; x < METRICS_COUNT; x++)
+    fprintf(out, "%s %.1f\n", metrics[x].name, metrics[x].value);
+}
+
+//returns the number of regressions.
+int compareBaseline(const char* baselineFile) {
+  FILE* baseline = fopen(baselineFile, "r");
+  if(!baseline) { fprintf(stderr, "cannot open %s\n", baselineFile); return 1; }
+  char name[40];
+  double expected;
+  int regressions = 0;
+  while(fscanf(baseline, "%39s %lf", name, &expected) == 2) {
+    for(int x = 0; x < METRICS_COUNT; x++) {
+      if(strcmp(name, metrics[x].name) != 0) continue;
+      double worse = metrics[x].better == 0 ? fabs(metrics[x].value - expected) : metrics[x].better * (expected - metrics[x].value);
+      if(worse > metrics[x].tolerance) {
+        printf("REGRESSION %s: baseline %.1f, now %.1f\n", name, expected, metrics[x].value);
+        regressions++;
+      }
+    }
+  }
+  fclose(baseline);
+  return regressions;
+}
+
+//reports the detection of the injected fault, returns true when it failed.
+bool checkInjection(long maxLatency) {
+  byte expected = injectFaults[injectType];
+  long latency = faultAt ? (long)(faultAt - injectAt) : -1;
+  printf("injected %s @%lums: fault %d, latency %ld ms\n", injectNames[injectType], injectAt, engine.getFault(), latency);
+  if(engine.getFault() != expected) {
+    printf("FAILED %s: expected fault %d, got %d\n", injectNames[injectType], expected, engine.getFault());
+    return true;
+  }
+  if(expected != FAULT_NONE && maxLatency >= 0 && latency > maxLatency) {
+    printf("FAILED %s: detected after %ld ms, limit %ld ms\n", injectNames[injectType], latency, maxLatency);
+    return true;
+  }
+  return false;
+}
+
+int main(int argc, char** argv) {
+  const char *traceIn = NULL, *traceOut = NULL, *baselineIn = NULL, *baselineOut = NULL;
+  long maxLatency = -1;
+  for(int x = 1; x < argc; x++) {
+    if(strcmp(argv[x], "-t") == 0 && x + 1 < argc) traceIn = argv[++x];
+    else if(strcmp(argv[x], "-o") == 0 && x + 1 < argc) traceOut = argv[++x];
+    else if(strcmp(argv[x], "-b") == 0 && x + 1 < argc) baselineIn = argv[++x];
+    else if(strcmp(argv[x], "-w") == 0 && x + 1 < argc) baselineOut = argv[++x];
+    else if(strcmp(argv[x], "-p") == 0) program.preHeat = true;
+    else if(strcmp(argv[x], "-l") == 0 && x + 1 < argc) maxLatency = atol(argv[++x]);
+    else if(strcmp(argv[x], "-f") == 0 && x + 1 < argc) {
+      char name[10];
+      double seconds;
+      x++;
+      if(sscanf(argv[x], "%9[a-z]@%lf", name, &seconds) == 2)
+        for(byte type = INJECT_OPEN; type <= INJECT_SPIKE; type++)
+          if(strcmp(name, injectNames[type]) == 0) injectType = type;
+      if(injectType == INJECT_NONE) { fprintf(stderr, "invalid fault %s\n", argv[x]); return 2; }
+      injectAt = seconds * 1000;
+    }
+    else if(program.stepsCount < MAX_STEPS) {
+      int seconds, temp;
+      if(sscanf(argv[x], "%d:%d", &seconds, &temp) != 2) { fprintf(stderr, "invalid step %s\n", argv[x]); return 2; }
+      program.steps[program.stepsCount].timeInSec = seconds;
+      program.steps[program.stepsCount++].temp = temp;
+    }
+  }
+  if(program.stepsCount == 0) {
+    fprintf(stderr, "usage: fryer_replay [-t trace.csv] [-o trace.csv] [-p] [-b baseline.txt] [-w baseline.txt] [-f fault@seconds [-l ms]] <seconds>:<temp> ...\n");
+    return 2;
+  }
+  engine.setProduct(&program);
+  int result = traceIn ? replay(traceIn) : simulate(traceOut);
+  if(result != 0) return result;
+
+  metrics[FAULT].value = engine.getFault();
+  writeMetrics(stdout);
+  if(baselineOut) {
+    FILE* out = fopen(baselineOut, "w");
+    writeMetrics(out);
+    fclose(out);
+  }
+  int failed = baselineIn && compareBaseline(baselineIn) > 0;
+  if(injectType != INJECT_NONE && !traceIn)
+    failed |= checkInjection(maxLatency);
+  return failed ? 1 : 0;
+}